@@ -15,6 +15,7 @@
 #     GMatElastoPlasticFiniteStrainSimo::compiler_warnings - enable compiler warnings
 #     GMatElastoPlasticFiniteStrainSimo::assert - enable library assertions
 #     GMatElastoPlasticFiniteStrainSimo::debug - enable all assertions (slow)
+#     GMatElastoPlasticFiniteStrainSimo::instrumentation - collect counters during refresh
 
 include(CMakeFindDependencyMacro)
 
@@ -65,3 +66,13 @@ if(NOT TARGET GMatElastoPlasticFiniteStrainSimo::debug)
         GMATTENSOR_ENABLE_ASSERT
         XTENSOR_ENABLE_ASSERT)
 endif()
+
+# Define support target "GMatElastoPlasticFiniteStrainSimo::instrumentation"
+
+if(NOT TARGET GMatElastoPlasticFiniteStrainSimo::instrumentation)
+    add_library(GMatElastoPlasticFiniteStrainSimo::instrumentation INTERFACE IMPORTED)
+    set_property(
+        TARGET GMatElastoPlasticFiniteStrainSimo::instrumentation
+        PROPERTY INTERFACE_COMPILE_DEFINITIONS
+        GMATELASTOPLASTICFINITESTRAINSIMO_ENABLE_INSTRUMENTATION)
+endif()
@@ -0,0 +1,293 @@
+/**
+Throughput benchmarks (points per second) of the material models and the free functions.
+The results are written as JSON, such that they can be compared across versions.
+
+Usage:
+
+    benchmark [--output FILE] [--min-time SECONDS] [--max-size N] [--max-threads N]
+
+\file
+\copyright Copyright. Tom de Geus. All rights reserved.
+\license This project is released under the MIT License.
+*/
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <GMatElastoPlasticFiniteStrainSimo/Cartesian3d.h>
+#include <GMatElastoPlasticFiniteStrainSimo/version.h>
+
+namespace GMat = GMatElastoPlasticFiniteStrainSimo::Cartesian3d;
+
+/**
+Benchmark settings (from the command line).
+*/
+struct Settings {
+    std::string output = ""; ///< Output file (stdout if empty).
+    double min_time = 0.2; ///< Minimal measured time per benchmark [s].
+    size_t max_size = size_t(1) << 20; ///< Largest number of points.
+    size_t max_threads = 0; ///< Largest number of threads (0: `omp_get_max_threads()`).
+};
+
+/**
+One measurement.
+*/
+struct Result {
+    std::string model; ///< E.g. "LinearHardening" (or "free" for the free functions).
+    std::string function; ///< E.g. "refresh(true)".
+    std::string loading; ///< "elastic", "plastic", or "band".
+    std::string schedule; ///< Schedule, e.g. "Static".
+    size_t size; ///< Number of points.
+    size_t threads; ///< Number of threads.
+    size_t repeat; ///< Number of calls.
+    double seconds; ///< Time per call [s].
+};
+
+/**
+Time a function: call it until the total time exceeds `min_time` (after one warm-up call).
+\param f Function.
+\param min_time Minimal total time [s].
+\param repeat Output: number of calls.
+\return Time per call [s].
+*/
+double timeit(const std::function<void()>& f, double min_time, size_t& repeat)
+{
+    using clock = std::chrono::steady_clock;
+
+    f();
+
+    repeat = 0;
+    auto start = clock::now();
+    double elapsed = 0.0;
+
+    while (elapsed < min_time || repeat == 0) {
+        f();
+        ++repeat;
+        elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    }
+
+    return elapsed / static_cast<double>(repeat);
+}
+
+/**
+Deformation gradient that loads all points elastically (small strain) or plastically.
+\param size Number of points.
+\param plastic Apply large strain.
+\return [size, 3, 3].
+*/
+xt::xtensor<double, 3> deformation(size_t size, bool plastic)
+{
+    double gamma = plastic ? 0.1 : 1e-4;
+    xt::xtensor<double, 3> F = xt::zeros<double>({size, size_t(3), size_t(3)});
+
+    for (size_t i = 0; i < size; ++i) {
+        double s = gamma * (1.0 + static_cast<double>(i % 7) / 7.0);
+        F(i, 0, 0) = 1.0 + s;
+        F(i, 1, 1) = 1.0 / (1.0 + s);
+        F(i, 2, 2) = 1.0;
+        F(i, 0, 1) = s;
+    }
+
+    return F;
+}
+
+/**
+Run all benchmarks for a given number of points and threads.
+\param size Number of points.
+\param threads Number of threads.
+\param settings Settings.
+\param ret Output: results are appended.
+*/
+void run(size_t size, size_t threads, const Settings& settings, std::vector<Result>& ret)
+{
+    std::array<size_t, 1> shape = {size};
+    size_t repeat;
+    double t;
+    const char* schedule = "Static";
+
+    auto add = [&](const char* model, const char* function, const char* loading) {
+        ret.push_back(Result{model, function, loading, schedule, size, threads, repeat, t});
+    };
+
+    for (bool plastic : {false, true}) {
+
+        const char* loading = plastic ? "plastic" : "elastic";
+        auto F = deformation(size, plastic);
+
+        // Elastic: the loading does not change the cost
+        if (!plastic) {
+            GMat::Elastic<1> mat(shape, 1.0, 1.0);
+            mat.F() = F;
+            t = timeit([&]() { mat.refresh(true); }, settings.min_time, repeat);
+            add("Elastic", "refresh(true)", loading);
+            t = timeit([&]() { mat.refresh(false); }, settings.min_time, repeat);
+            add("Elastic", "refresh(false)", loading);
+        }
+
+        // LinearHardening: "elastic" stays below the yield stress, "plastic" yields everywhere
+        GMat::LinearHardening<1> mat(shape, 1.0, 1.0, plastic ? 1e-6 : 1.0, 0.1);
+        mat.F() = F;
+        t = timeit([&]() { mat.refresh(true); }, settings.min_time, repeat);
+        add("LinearHardening", "refresh(true)", loading);
+        t = timeit([&]() { mat.refresh(false); }, settings.min_time, repeat);
+        add("LinearHardening", "refresh(false)", loading);
+        // (increment() only does work after an update of the trial state)
+        t = timeit(
+            [&]() {
+                mat.refresh(false);
+                mat.increment();
+            },
+            settings.min_time,
+            repeat);
+        add("LinearHardening", "refresh(false) + increment()", loading);
+
+        // free functions
+        xt::xtensor<double, 3> Eps = xt::empty<double>(F.shape());
+        xt::xtensor<double, 1> eq = xt::empty<double>(shape);
+        t = timeit([&]() { GMat::strain(F, Eps); }, settings.min_time, repeat);
+        add("free", "strain", loading);
+        t = timeit([&]() { GMat::epseq(Eps, eq); }, settings.min_time, repeat);
+        add("free", "epseq", loading);
+        t = timeit([&]() { GMat::sigeq(Eps, eq); }, settings.min_time, repeat);
+        add("free", "sigeq", loading);
+    }
+
+    // LinearHardening: only a contiguous band of 1/8 of the points yields, for each schedule
+    xt::xtensor<double, 1> ones = xt::ones<double>(shape);
+    xt::xtensor<double, 1> H = xt::empty<double>(shape);
+    xt::xtensor<double, 1> tauy0 = xt::ones<double>(shape);
+    H.fill(0.1);
+    for (size_t i = size / 2; i < size / 2 + size / 8; ++i) {
+        tauy0(i) = 1e-6;
+    }
+
+    std::vector<std::pair<const char*, GMat::Schedule>> schedules = {
+        {"Static", GMat::Schedule::Static},
+        {"Pinned", GMat::Schedule::Pinned},
+        {"Balanced", GMat::Schedule::Balanced},
+        {"Dynamic", GMat::Schedule::Dynamic}};
+
+    for (auto& s : schedules) {
+        schedule = s.first;
+        GMat::LinearHardening<1> mat(ones, ones, tauy0, H);
+        mat.set_schedule(s.second);
+        mat.F() = deformation(size, true);
+        mat.refresh(false);
+        t = timeit([&]() { mat.refresh(true); }, settings.min_time, repeat);
+        add("LinearHardening", "refresh(true)", "band");
+    }
+}
+
+/**
+Write the results as JSON.
+\param settings Settings.
+\param results Results.
+\param os Output stream.
+*/
+void write_json(const Settings& settings, const std::vector<Result>& results, std::ostream& os)
+{
+    os << "{\n";
+    os << "  \"version\": \"" << GMatElastoPlasticFiniteStrainSimo::version() << "\",\n";
+    os << "  \"dependencies\": [";
+    auto deps = GMatElastoPlasticFiniteStrainSimo::version_dependencies();
+    for (size_t i = 0; i < deps.size(); ++i) {
+        os << (i > 0 ? ", " : "") << "\"" << deps[i] << "\"";
+    }
+    os << "],\n";
+#ifdef XTENSOR_USE_XSIMD
+    os << "  \"simd\": true,\n";
+#else
+    os << "  \"simd\": false,\n";
+#endif
+    os << "  \"min_time\": " << settings.min_time << ",\n";
+    os << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        os << "    {\"model\": \"" << r.model << "\", \"function\": \"" << r.function
+           << "\", \"loading\": \"" << r.loading << "\", \"schedule\": \"" << r.schedule
+           << "\", \"size\": " << r.size
+           << ", \"threads\": " << r.threads << ", \"repeat\": " << r.repeat
+           << ", \"seconds\": " << r.seconds
+           << ", \"points_per_second\": " << static_cast<double>(r.size) / r.seconds << "}"
+           << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n";
+    os << "}\n";
+}
+
+int main(int argc, char* argv[])
+{
+    Settings settings;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value of " << arg << std::endl;
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (arg == "--output") {
+            settings.output = value;
+        }
+        else if (arg == "--min-time") {
+            settings.min_time = std::stod(value);
+        }
+        else if (arg == "--max-size") {
+            settings.max_size = std::stoul(value);
+        }
+        else if (arg == "--max-threads") {
+            settings.max_threads = std::stoul(value);
+        }
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    size_t max_threads = 1;
+#ifdef _OPENMP
+    max_threads = static_cast<size_t>(omp_get_max_threads());
+#endif
+    if (settings.max_threads > 0) {
+        max_threads = std::min(max_threads, settings.max_threads);
+    }
+
+    // powers of two, and the maximal number of threads
+    std::vector<size_t> threads_list;
+    for (size_t threads = 1; threads < max_threads; threads *= 2) {
+        threads_list.push_back(threads);
+    }
+    threads_list.push_back(max_threads);
+
+    std::vector<Result> results;
+
+    // from L1-resident (2^8 points) to DRAM-bound (2^20 points, about 1 GB for LinearHardening)
+    for (size_t size = 256; size <= settings.max_size; size *= 16) {
+        for (size_t threads : threads_list) {
+#ifdef _OPENMP
+            omp_set_num_threads(static_cast<int>(threads));
+#endif
+            run(size, threads, settings, results);
+        }
+    }
+
+    if (settings.output.empty()) {
+        write_json(settings, results, std::cout);
+        return 0;
+    }
+
+    std::ofstream file(settings.output);
+    write_json(settings, results, file);
+    return 0;
+}
@@ -8,6 +8,16 @@
 #define GMATELASTOPLASTICFINITESTRAINSIMO_CARTESIAN3D_H
 
 #include <GMatTensor/Cartesian3d.h>
+#include <chrono>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef XTENSOR_USE_XSIMD
+#include <xsimd/xsimd.hpp>
+#endif
 
 #include "config.h"
 #include "version.h"
@@ -20,150 +30,3786 @@ Implementation in a 3-d Cartesian coordinate frame.
 namespace Cartesian3d {
 
 /**
-Von Mises equivalent strain: norm of strain deviator
+Storage of the tangent computed by `refresh(true)`.
+*/
+enum class TangentStorage {
+    Full, ///< Full tangent, see `C()`: [..., 3, 3, 3, 3].
+    Mandel ///< Symmetric part of the tangent in Mandel notation, see `C_mandel()`: [..., 6, 6].
+};
+
+/**
+Tangent computed by `refresh(true)` (see e.g. `set_tangent_policy()`).
+This allows a modified Newton scheme in which the caller always asks for the tangent,
+while it is only recomputed when the policy requires it.
+*/
+enum class TangentPolicy {
+    Consistent, ///< Consistent tangent, recomputed by each `refresh(true)`.
+    Frozen, ///< Consistent tangent of the first `refresh(true)` (of each increment), then kept.
+    InitialElastic, ///< Elastic tangent of the undeformed state, computed once from "K" and "G".
+    Interval ///< Consistent tangent, recomputed by every `tangent_interval()`-th `refresh(true)`.
+};
+
+/**
+Memory layout of the internal state that is stored as packed symmetric tensors
+(see e.g. `Sig_packed()`).
+The deformation gradient and the tangent are always stored item-by-item.
+*/
+enum class Layout {
+    AoS, ///< Array of structs: the components of each item are contiguous: [..., 6].
+    SoA ///< Struct of arrays: each component is contiguous across items: [6, ...].
+};
+
+/**
+Distribution of the items over the threads (see e.g. `set_schedule()`).
+It is used by all loops over all items: refresh(), increment(), and the initialisation and
+(bulk) copies of the state.
+Memory pages are thereby first touched by the thread that later updates the corresponding items,
+such that they are placed in the memory of its NUMA node (with threads bound to cores,
+e.g. `OMP_PROC_BIND=close`).
+*/
+enum class Schedule {
+    Static, ///< Static `omp for` over batches of items, for the current number of threads.
+    Pinned, ///< Each thread owns a fixed contiguous block of items (see `set_schedule()`).
+    Balanced, ///< As Schedule::Pinned, with blocks of equal estimated cost (`set_schedule()`).
+    Dynamic ///< Dynamic `omp for` over chunks of items, see `detail::dynamic_chunk`.
+};
+
+/**
+Solver used for the eigenvalue decomposition of the (trial) elastic Finger tensor.
+Eigensolver::Analytic and Eigensolver::Jacobi fall back to Eigensolver::Default
+if their result is not accurate (see e.g. `eigensolver_fallbacks()`).
+*/
+enum class Eigensolver {
+    Default, ///< `GMatTensor::Cartesian3d::pointer::eigs`.
+    Analytic, ///< Closed-form (trigonometric) solution.
+    Jacobi ///< Jacobi rotations, warm-started from the eigenvectors of the previous refresh.
+};
+
+/**
+Storage of the material parameters (e.g. `K()`).
+*/
+enum class ParameterStorage {
+    Item, ///< One parameter set per item.
+    Phase, ///< Table of parameter sets, and the index of the set ("phase") per item.
+    Uniform ///< One parameter set for all items.
+};
+
+/**
+Derived output fields that refresh() computes per item on request (see e.g. `set_outputs()`).
+The flags can be combined, e.g. `Output::Sigeq | Output::Epseq`.
+*/
+enum class Output : unsigned {
+    None = 0, ///< No derived output.
+    Sigeq = 1 << 0, ///< Equivalent Cauchy stress, see Sigeq().
+    Epseq = 1 << 1, ///< Equivalent logarithmic strain, see Epseq() and Strain().
+    J = 1 << 2, ///< Volume change ratio `det(F)`.
+    Energy = 1 << 3, ///< Elastic energy stored per unit reference volume.
+    Dissipation = 1 << 4 ///< Plastic dissipation of the current increment (LinearHardening).
+};
+
+/**
+Combine output flags.
+\param a Flags.
+\param b Flags.
+\return Union of `a` and `b`.
+*/
+inline Output operator|(Output a, Output b)
+{
+    return static_cast<Output>(static_cast<unsigned>(a) | static_cast<unsigned>(b));
+}
+
+/**
+Intersect output flags.
+\param a Flags.
+\param b Flags.
+\return Intersection of `a` and `b`.
+*/
+inline Output operator&(Output a, Output b)
+{
+    return static_cast<Output>(static_cast<unsigned>(a) & static_cast<unsigned>(b));
+}
+
+/**
+Counters collected by the last call that updated the stress (e.g. refresh()),
+see `GMATELASTOPLASTICFINITESTRAINSIMO_ENABLE_INSTRUMENTATION`.
+Times are in seconds, summed over all threads.
+*/
+struct Instrumentation {
+    bool enabled = false; ///< `true` if compiled with instrumentation (otherwise all zero).
+    double kinematics = 0.0; ///< Time to compute the (trial) elastic Finger tensor.
+    double eigs = 0.0; ///< Time of the eigenvalue decomposition.
+    double stress = 0.0; ///< Time of the (return map and) stress, and the derived outputs.
+    double tangent = 0.0; ///< Time of the tangent.
+    size_t items = 0; ///< Number of items that were updated.
+    size_t yielded = 0; ///< Number of items that yielded: `phi > 0` (LinearHardening).
+    size_t degenerate = 0; ///< Number of pairs of equal eigenvalues in the tangent.
+    std::vector<size_t> thread_items; ///< Number of items updated per thread.
+    std::vector<size_t> thread_yielded; ///< Number of items that yielded per thread.
+    std::vector<double> thread_time; ///< Time per thread (all phases).
+};
+
+namespace detail {
+
+/**
+Divided difference of the logarithm: \f$ (\ln b - \ln a) / (b - a) \f$, or \f$ 1 / a \f$ if
+\f$ a = b \f$.
+Evaluated as `log1p(u) / (u a)` with `u = (b - a) / a` such that it is also accurate if
+\f$ a \approx b \f$.
+
+\param a Positive number.
+\param b Positive number.
+\return Divided difference.
+*/
+inline double dlog(double a, double b)
+{
+    double u = (b - a) / a;
+
+    if (u == 0.0) {
+        return 1.0 / a;
+    }
+
+    return std::log1p(u) / (u * a);
+}
+
+/**
+Consistent tangent, assembled directly in the eigenbasis of the (trial) elastic Finger tensor
+"Be" and rotated back to the original coordinate frame once.
+
+The linearisation of the Kirchhoff stress is assumed of the form
+
+    dTau_dlnBe = a * II + b * I4s + c * N x N
+
+with "N" coaxial with "Be".
+In the eigenbasis the tangent
+
+    C = -I4rt . Sig + (dTau_dlnBe : dlnBe_dBe : dBe_dLT) / J
+
+only has non-zero components:
+
+    C_pppp = 2 * (a + b + c * N_p * N_p) / J - Sig_p
+    C_ppqq = 2 * (a + c * N_p * N_q) / J                      (p != q)
+    C_pqpq = b * Be_q * (ln(Be_q) - ln(Be_p)) / (Be_q - Be_p) / J - Sig_q  (p != q)
+    C_pqqp = b * Be_p * (ln(Be_q) - ln(Be_p)) / (Be_q - Be_p) / J          (p != q)
+
+\param vec Eigenvectors of "Be": `vec[i * 3 + p]` is component `i` of eigenvector `p`.
+\param Be_val Eigenvalues of "Be" [3].
+\param Sig_val Eigenvalues of the Cauchy stress [3].
+\param N_val Eigenvalues of "N" [3] (only read if `c != 0`).
+\param a Coefficient of "II".
+\param b Coefficient of "I4s".
+\param c Coefficient of "N x N".
+\param J Volume change ratio.
+\param C Output: tangent [3, 3, 3, 3] (assembled in `double`, stored as `U`).
+*/
+template <class U>
+inline void spectral_tangent(
+    const double* vec,
+    const double* Be_val,
+    const double* Sig_val,
+    const double* N_val,
+    double a,
+    double b,
+    double c,
+    double J,
+    U* C)
+{
+    // dyadic products of eigenvectors: Q[(p * 3 + q) * 9 + i * 3 + j] = vec_i^p * vec_j^q
+    std::array<double, 81> Q;
+
+    for (size_t p = 0; p < 3; ++p) {
+        for (size_t q = 0; q < 3; ++q) {
+            for (size_t i = 0; i < 3; ++i) {
+                for (size_t j = 0; j < 3; ++j) {
+                    Q[(p * 3 + q) * 9 + i * 3 + j] = vec[i * 3 + p] * vec[j * 3 + q];
+                }
+            }
+        }
+    }
+
+    // "C_ppqq" contracted with the projections of the second pair of indices
+    std::array<double, 27> M;
+    M.fill(0.0);
+
+    for (size_t p = 0; p < 3; ++p) {
+        for (size_t q = 0; q < 3; ++q) {
+            double A = 2.0 * a / J;
+            if (c != 0.0) {
+                A += 2.0 * c * N_val[p] * N_val[q] / J;
+            }
+            if (p == q) {
+                A += 2.0 * b / J - Sig_val[p];
+            }
+            for (size_t kl = 0; kl < 9; ++kl) {
+                M[p * 9 + kl] += A * Q[(q * 3 + q) * 9 + kl];
+            }
+        }
+    }
+
+    // "C_pqpq" and "C_pqqp" (p != q) contracted with the second pair of indices
+    std::array<size_t, 6> P = {0, 0, 1, 1, 2, 2};
+    std::array<size_t, 6> R = {1, 2, 0, 2, 0, 1};
+    std::array<double, 54> S;
+
+    for (size_t r = 0; r < 6; ++r) {
+        size_t p = P[r];
+        size_t q = R[r];
+        double X = b * dlog(Be_val[p], Be_val[q]) / J;
+        double Cpqpq = X * Be_val[q] - Sig_val[q];
+        double Cpqqp = X * Be_val[p];
+        for (size_t kl = 0; kl < 9; ++kl) {
+            S[r * 9 + kl] = Cpqpq * Q[(p * 3 + q) * 9 + kl] + Cpqqp * Q[(q * 3 + p) * 9 + kl];
+        }
+    }
+
+    // rotate to the original coordinate frame
+    for (size_t ij = 0; ij < 9; ++ij) {
+        for (size_t kl = 0; kl < 9; ++kl) {
+            double ret = 0.0;
+            for (size_t p = 0; p < 3; ++p) {
+                ret += Q[(p * 3 + p) * 9 + ij] * M[p * 9 + kl];
+            }
+            for (size_t r = 0; r < 6; ++r) {
+                ret += Q[(P[r] * 3 + R[r]) * 9 + ij] * S[r * 9 + kl];
+            }
+            C[ij * 9 + kl] = static_cast<U>(ret);
+        }
+    }
+}
+
+/**
+Coefficients of the linearisation of the linear hardening model,
+`dTau_dlnBe = a * II + b * I4s + c * N x N` (see spectral_tangent()).
+\param K Bulk modulus.
+\param G Shear modulus.
+\param M Denominator of the return map, `3 G + H` (see plastic_modulus()).
+\param dgamma Plastic strain increment (zero if elastic).
+\param taueq Trial equivalent Kirchhoff stress.
+\param a Output: coefficient of "II".
+\param b Output: coefficient of "I4s".
+\param c Output: coefficient of "N x N".
+*/
+inline void linear_hardening_tangent(
+    double K,
+    double G,
+    double M,
+    double dgamma,
+    double taueq,
+    double& a,
+    double& b,
+    double& c)
+{
+    // elastic: use that "Tau := Ce : Eps = 0.5 * Ce : ln(Be)"
+    a = 0.5 * K - G / 3.0;
+    b = G;
+    c = 0.0;
+
+    // elasto-plastic
+    if (dgamma > 0.0) {
+        double a0 = dgamma * G / taueq;
+        double a1 = G / M;
+        a = 0.5 * (K - 2.0 / 3.0 * G) + a0 * G;
+        b = (1.0 - 3.0 * a0) * G;
+        c = 2.0 * G * (a0 - a1);
+    }
+}
+
+/**
+Index pairs `(mandel_i[I], mandel_j[I])` of the components of a symmetric second-order tensor in
+Mandel notation (and in packed storage): `(0, 0), (1, 1), (2, 2), (1, 2), (0, 2), (0, 1)`.
+*/
+constexpr std::array<size_t, 6> mandel_i = {0, 1, 2, 1, 0, 0};
+
+/**
+See mandel_i.
+*/
+constexpr std::array<size_t, 6> mandel_j = {0, 1, 2, 2, 2, 1};
+
+/**
+Packed storage of a symmetric second-order tensor, using the order of mandel_i and mandel_j
+(without scaling the off-diagonal components).
+\param A Symmetric tensor [3, 3].
+\param ret Output: packed tensor [6].
+*/
+template <class T>
+inline void pack(const T* A, T* ret)
+{
+    for (size_t I = 0; I < 6; ++I) {
+        ret[I] = A[mandel_i[I] * 3 + mandel_j[I]];
+    }
+}
+
+/**
+Expand a packed symmetric second-order tensor (inverse of pack()).
+\param A Packed tensor [6].
+\param ret Output: symmetric tensor [3, 3].
+*/
+template <class T>
+inline void unpack(const T* A, T* ret)
+{
+    for (size_t I = 0; I < 6; ++I) {
+        ret[mandel_i[I] * 3 + mandel_j[I]] = A[I];
+        ret[mandel_j[I] * 3 + mandel_i[I]] = A[I];
+    }
+}
+
+/**
+Packed symmetric tensor from its spectral decomposition.
+\param vec Eigenvectors: `vec[i * 3 + p]` is component `i` of eigenvector `p`.
+\param val Eigenvalues [3].
+\param ret Output: packed tensor [6].
+*/
+template <class T>
+inline void from_eigs_packed(const T* vec, const T* val, T* ret)
+{
+    for (size_t I = 0; I < 6; ++I) {
+        size_t i = mandel_i[I];
+        size_t j = mandel_j[I];
+        ret[I] = vec[i * 3] * val[0] * vec[j * 3] + vec[i * 3 + 1] * val[1] * vec[j * 3 + 1] +
+                 vec[i * 3 + 2] * val[2] * vec[j * 3 + 2];
+    }
+}
+
+/**
+Number of items that are evaluated in lockstep by the stress kernels, and loading and storing
+of the corresponding numbers.
+The kernels below are written for a generic `T`, which is either `double` (one item),
+or a SIMD batch (`xsimd::batch<double>`: one item per lane).
+\tparam T `double` or `xsimd::batch<double>`.
+*/
+template <class T>
+struct lanes;
+
+/**
+One item.
+*/
+template <>
+struct lanes<double> {
+    constexpr static size_t size = 1; ///< Number of items.
+
+    /**
+    Load number.
+    \param ptr Pointer to the number.
+    \return Number.
+    */
+    static double load(const double* ptr)
+    {
+        return *ptr;
+    }
+
+    /**
+    Store number.
+    \param arg Number.
+    \param ptr Output: pointer to the number.
+    */
+    static void store(double arg, double* ptr)
+    {
+        *ptr = arg;
+    }
+};
+
+/**
+Select between `a` and `b`, mirroring `xsimd::select` for one item.
+\param cond Condition.
+\param a Returned if `cond` is `true`.
+\param b Returned if `cond` is `false`.
+\return `a` or `b`.
+*/
+inline double select(bool cond, double a, double b)
+{
+    return cond ? a : b;
+}
+
+/**
+Check if the condition is `true` for any item, mirroring `xsimd::any` for one item.
+\param cond Condition.
+\return `cond`.
+*/
+inline bool any(bool cond)
+{
+    return cond;
+}
+
+#ifdef XTENSOR_USE_XSIMD
+
+/**
+One item per lane of a SIMD batch.
+*/
+template <class A>
+struct lanes<xsimd::batch<double, A>> {
+    using type = xsimd::batch<double, A>; ///< Batch type.
+    constexpr static size_t size = type::size; ///< Number of items.
+
+    /**
+    Load numbers.
+    \param ptr Pointer to the first of #size numbers.
+    \return Batch.
+    */
+    static type load(const double* ptr)
+    {
+        return type::load_unaligned(ptr);
+    }
+
+    /**
+    Store numbers.
+    \param arg Batch.
+    \param ptr Output: pointer to the first of #size numbers.
+    */
+    static void store(const type& arg, double* ptr)
+    {
+        arg.store_unaligned(ptr);
+    }
+};
+
+/**
+Type used to update the stress of several items in lockstep.
+*/
+using batch_type = xsimd::batch<double>;
+
+#else
+
+/**
+Type used to update the stress of several items in lockstep (no SIMD: one item at a time).
+*/
+using batch_type = double;
+
+#endif
+
+/**
+Load a number of components of lanes<T>::size consecutive items.
+Component `c` of item `w` is read from `data[w * stride_item + c * stride_comp]`.
+\param data Pointer to the first component of the first item.
+\param stride_item Distance between items.
+\param stride_comp Distance between components.
+\param ncomp Number of components to load.
+\param ret Output: components [ncomp].
+*/
+template <class T>
+inline void gather(
+    const double* data,
+    size_t stride_item,
+    size_t stride_comp,
+    size_t ncomp,
+    T* ret)
+{
+    constexpr size_t W = lanes<T>::size;
+
+    if (stride_item == 1) {
+        for (size_t c = 0; c < ncomp; ++c) {
+            ret[c] = lanes<T>::load(&data[c * stride_comp]);
+        }
+        return;
+    }
+
+    std::array<double, W> buffer;
+
+    for (size_t c = 0; c < ncomp; ++c) {
+        for (size_t w = 0; w < W; ++w) {
+            buffer[w] = data[w * stride_item + c * stride_comp];
+        }
+        ret[c] = lanes<T>::load(&buffer[0]);
+    }
+}
+
+/**
+Store a number of components of lanes<T>::size consecutive items (inverse of gather()).
+\param arg Components [ncomp].
+\param stride_item Distance between items.
+\param stride_comp Distance between components.
+\param ncomp Number of components to store.
+\param data Output: pointer to the first component of the first item.
+*/
+template <class T>
+inline void scatter(
+    const T* arg,
+    size_t stride_item,
+    size_t stride_comp,
+    size_t ncomp,
+    double* data)
+{
+    constexpr size_t W = lanes<T>::size;
+
+    if (stride_item == 1) {
+        for (size_t c = 0; c < ncomp; ++c) {
+            lanes<T>::store(arg[c], &data[c * stride_comp]);
+        }
+        return;
+    }
+
+    std::array<double, W> buffer;
+
+    for (size_t c = 0; c < ncomp; ++c) {
+        lanes<T>::store(arg[c], &buffer[0]);
+        for (size_t w = 0; w < W; ++w) {
+            data[w * stride_item + c * stride_comp] = buffer[w];
+        }
+    }
+}
+
+/**
+Tag to specialise kernels for a ParameterStorage at compile time.
+*/
+template <ParameterStorage S>
+using parameter_storage = std::integral_constant<ParameterStorage, S>;
+
+/**
+Load a material parameter of lanes<T>::size consecutive items (ParameterStorage::Item).
+\param item Parameter per item.
+\param phase Phase per item (not used).
+\param table Parameter per phase (not used).
+\param i Index of the first item.
+\return Parameter.
+*/
+template <class T>
+inline T parameter(
+    parameter_storage<ParameterStorage::Item>,
+    const double* item,
+    const size_t* /* phase */,
+    const double* /* table */,
+    size_t i)
+{
+    return lanes<T>::load(&item[i]);
+}
+
+/**
+Load a material parameter of lanes<T>::size consecutive items (ParameterStorage::Phase).
+\param item Parameter per item (not used).
+\param phase Phase per item.
+\param table Parameter per phase.
+\param i Index of the first item.
+\return Parameter.
+*/
+template <class T>
+inline T parameter(
+    parameter_storage<ParameterStorage::Phase>,
+    const double* /* item */,
+    const size_t* phase,
+    const double* table,
+    size_t i)
+{
+    std::array<double, lanes<T>::size> buffer;
+
+    for (size_t w = 0; w < lanes<T>::size; ++w) {
+        buffer[w] = table[phase[i + w]];
+    }
+
+    return lanes<T>::load(&buffer[0]);
+}
+
+/**
+Load a material parameter of lanes<T>::size consecutive items (ParameterStorage::Uniform).
+\param item Parameter per item (not used).
+\param phase Phase per item (not used).
+\param table The parameter of all items [1].
+\param i Index of the first item (not used).
+\return Parameter.
+*/
+template <class T>
+inline T parameter(
+    parameter_storage<ParameterStorage::Uniform>,
+    const double* /* item */,
+    const size_t* /* phase */,
+    const double* table,
+    size_t /* i */)
+{
+    return T(table[0]);
+}
+
+/**
+Denominator of the return map of the linear hardening model, `3 G + H`,
+of lanes<T>::size consecutive items (ParameterStorage::Item: evaluated per item).
+\param G Shear modulus.
+\param H Hardening modulus.
+\param phase Phase per item (not used).
+\param table `3 G + H` per phase (not used).
+\param i Index of the first item (not used).
+\return `3 G + H`.
+*/
+template <class T>
+inline T plastic_modulus(
+    parameter_storage<ParameterStorage::Item>,
+    const T& G,
+    const T& H,
+    const size_t* /* phase */,
+    const double* /* table */,
+    size_t /* i */)
+{
+    return 3.0 * G + H;
+}
+
+/**
+Denominator of the return map of the linear hardening model, `3 G + H`,
+of lanes<T>::size consecutive items (ParameterStorage::Phase and ParameterStorage::Uniform:
+read from the table evaluated once per phase).
+\param s Storage of the material parameters.
+\param G Shear modulus (not used).
+\param H Hardening modulus (not used).
+\param phase Phase per item.
+\param table `3 G + H` per phase.
+\param i Index of the first item.
+\return `3 G + H`.
+*/
+template <class T, ParameterStorage S>
+inline T plastic_modulus(
+    parameter_storage<S> s,
+    const T& /* G */,
+    const T& /* H */,
+    const size_t* phase,
+    const double* table,
+    size_t i)
+{
+    return parameter<T>(s, nullptr, phase, table, i);
+}
+
+/**
+Determinant.
+\param A Tensor [3, 3].
+\return Determinant.
+*/
+template <class T>
+inline T det(const T* A)
+{
+    return A[0] * (A[4] * A[8] - A[5] * A[7]) - A[1] * (A[3] * A[8] - A[5] * A[6]) +
+           A[2] * (A[3] * A[7] - A[4] * A[6]);
+}
+
+/**
+Inverse.
+\param A Tensor [3, 3].
+\param ret Output: inverse of `A` [3, 3].
+*/
+template <class T>
+inline void inv(const T* A, T* ret)
+{
+    T D = det(A);
+    ret[0] = (A[4] * A[8] - A[5] * A[7]) / D;
+    ret[1] = (A[2] * A[7] - A[1] * A[8]) / D;
+    ret[2] = (A[1] * A[5] - A[2] * A[4]) / D;
+    ret[3] = (A[5] * A[6] - A[3] * A[8]) / D;
+    ret[4] = (A[0] * A[8] - A[2] * A[6]) / D;
+    ret[5] = (A[2] * A[3] - A[0] * A[5]) / D;
+    ret[6] = (A[3] * A[7] - A[4] * A[6]) / D;
+    ret[7] = (A[1] * A[6] - A[0] * A[7]) / D;
+    ret[8] = (A[0] * A[4] - A[1] * A[3]) / D;
+}
+
+/**
+Dot product: `A . B`.
+\param A Tensor [3, 3].
+\param B Tensor [3, 3].
+\param ret Output: `A . B` [3, 3].
+*/
+template <class T>
+inline void dot(const T* A, const T* B, T* ret)
+{
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            ret[i * 3 + j] = A[i * 3] * B[j] + A[i * 3 + 1] * B[3 + j] + A[i * 3 + 2] * B[6 + j];
+        }
+    }
+}
+
+/**
+Symmetric product `A . A^T`.
+\param A Tensor [3, 3].
+\param ret Output: `A . A^T`, packed [6].
+*/
+template <class T>
+inline void dot_transpose_packed(const T* A, T* ret)
+{
+    for (size_t I = 0; I < 6; ++I) {
+        size_t i = mandel_i[I];
+        size_t j = mandel_j[I];
+        ret[I] = A[i * 3] * A[j * 3] + A[i * 3 + 1] * A[j * 3 + 1] + A[i * 3 + 2] * A[j * 3 + 2];
+    }
+}
+
+/**
+Push forward of a symmetric tensor: `A . B . A^T`.
+\param A Tensor [3, 3].
+\param B Symmetric tensor, packed [6].
+\param ret Output: `A . B . A^T`, packed [6].
+*/
+template <class T>
+inline void push_forward_packed(const T* A, const T* B, T* ret)
+{
+    std::array<T, 9> Bf;
+    std::array<T, 9> AB;
+    unpack(B, &Bf[0]);
+    dot(A, &Bf[0], &AB[0]);
+
+    for (size_t I = 0; I < 6; ++I) {
+        size_t i = mandel_i[I];
+        size_t j = mandel_j[I];
+        ret[I] = AB[i * 3] * A[j * 3] + AB[i * 3 + 1] * A[j * 3 + 1] + AB[i * 3 + 2] * A[j * 3 + 2];
+    }
+}
+
+/**
+Relative accuracy required from Eigensolver::Analytic and Eigensolver::Jacobi.
+If the residual \f$ || A v_p - \lambda_p v_p || \f$ of any eigenpair exceeds this tolerance times
+the norm of \f$ A \f$, the decomposition is recomputed using Eigensolver::Default.
+*/
+constexpr double eigs_tol = 1e-12;
+
+/**
+Maximum number of sweeps of Eigensolver::Jacobi.
+*/
+constexpr size_t eigs_jacobi_sweeps = 10;
+
+/**
+Check the accuracy of an eigenvalue decomposition.
+\param A Symmetric tensor, packed [6].
+\param vec Eigenvectors, `vec[i * 3 + p]` is component `i` of eigenvector `p` [9].
+\param val Eigenvalues [3].
+\return `true` if the residual of all eigenpairs is within #eigs_tol.
+*/
+inline bool eigs_accurate(const double* A, const double* vec, const double* val)
+{
+    std::array<double, 9> Af;
+    unpack(A, &Af[0]);
+
+    double norm = 0.0;
+    double res = 0.0;
+
+    for (size_t i = 0; i < 9; ++i) {
+        norm += Af[i] * Af[i];
+    }
+
+    for (size_t p = 0; p < 3; ++p) {
+        for (size_t i = 0; i < 3; ++i) {
+            double r = Af[i * 3] * vec[p] + Af[i * 3 + 1] * vec[3 + p] +
+                       Af[i * 3 + 2] * vec[6 + p] - val[p] * vec[i * 3 + p];
+            res += r * r;
+        }
+    }
+
+    return res <= eigs_tol * eigs_tol * norm;
+}
+
+/**
+Eigenvalue decomposition of a symmetric tensor in closed form.
+The eigenvalues follow from the trigonometric solution of the characteristic equation.
+The eigenvector of the eigenvalue that is best separated from the others is the largest cross
+product of two rows of "A - lambda I". The remaining two eigenvectors follow from the
+(2 x 2) problem in the plane normal to it, which is solved by one Jacobi rotation, such that
+(near-)degenerate eigenvalues are handled without special cases.
+\param A Symmetric tensor, packed [6].
+\param vec Output: eigenvectors, `vec[i * 3 + p]` is component `i` of eigenvector `p` [9].
+\param val Output: eigenvalues [3].
+\return `true` if the decomposition is accurate, see eigs_accurate().
+*/
+inline bool eigs_analytic(const double* A, double* vec, double* val)
+{
+    std::array<double, 9> Af;
+    unpack(A, &Af[0]);
+
+    // "A = q I + B", with "B" deviatoric
+    double q = (A[0] + A[1] + A[2]) / 3.0;
+    double b00 = A[0] - q;
+    double b11 = A[1] - q;
+    double b22 = A[2] - q;
+    double p2 = (b00 * b00 + b11 * b11 + b22 * b22 +
+                 2.0 * (A[3] * A[3] + A[4] * A[4] + A[5] * A[5])) /
+                6.0;
+
+    // isotropic: any basis is an eigenbasis
+    if (p2 == 0.0) {
+        for (size_t i = 0; i < 9; ++i) {
+            vec[i] = i % 4 == 0 ? 1.0 : 0.0;
+        }
+        val[0] = q;
+        val[1] = q;
+        val[2] = q;
+        return true;
+    }
+
+    // eigenvalues: "lambda = q + 2 p cos(phi)", with "cos(3 phi) = det(B / p) / 2"
+    double p = std::sqrt(p2);
+    double detB = b00 * (b11 * b22 - A[3] * A[3]) - A[5] * (A[5] * b22 - A[3] * A[4]) +
+                  A[4] * (A[5] * A[3] - b11 * A[4]);
+    double r = std::max(-1.0, std::min(1.0, detB / (2.0 * p2 * p)));
+    double phi = std::acos(r) / 3.0;
+    double lmax = q + 2.0 * p * std::cos(phi);
+    double lmin = q + 2.0 * p * std::cos(phi + std::acos(-0.5)); // "acos(-1/2) = 2 pi / 3"
+    double lmid = 3.0 * q - lmax - lmin;
+    double lambda = lmax - lmid >= lmid - lmin ? lmax : lmin;
+
+    // eigenvector of the best separated eigenvalue
+    std::array<double, 3> v;
+    std::array<double, 9> M = Af;
+    M[0] -= lambda;
+    M[4] -= lambda;
+    M[8] -= lambda;
+
+    double nmax = 0.0;
+
+    for (size_t k = 0; k < 3; ++k) {
+        const double* a = &M[(k == 2 ? 1 : 0) * 3];
+        const double* b = &M[(k == 0 ? 1 : 2) * 3];
+        std::array<double, 3> c = {
+            a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+        double n = c[0] * c[0] + c[1] * c[1] + c[2] * c[2];
+        if (n > nmax) {
+            nmax = n;
+            v = c;
+        }
+    }
+
+    if (!(nmax > 0.0)) {
+        return false;
+    }
+
+    nmax = std::sqrt(nmax);
+    for (size_t i = 0; i < 3; ++i) {
+        v[i] /= nmax;
+    }
+
+    // orthonormal basis "u", "w" of the plane normal to "v"
+    std::array<double, 3> u;
+    std::array<double, 3> w;
+
+    if (std::abs(v[0]) > std::abs(v[1])) {
+        double n = std::sqrt(v[0] * v[0] + v[2] * v[2]);
+        u = {-v[2] / n, 0.0, v[0] / n};
+    }
+    else {
+        double n = std::sqrt(v[1] * v[1] + v[2] * v[2]);
+        u = {0.0, v[2] / n, -v[1] / n};
+    }
+
+    w = {v[1] * u[2] - v[2] * u[1], v[2] * u[0] - v[0] * u[2], v[0] * u[1] - v[1] * u[0]};
+
+    // (2 x 2) problem in the plane, diagonalised by one Jacobi rotation
+    std::array<double, 3> Au;
+    std::array<double, 3> Aw;
+    std::array<double, 3> Av;
+    for (size_t i = 0; i < 3; ++i) {
+        Au[i] = Af[i * 3] * u[0] + Af[i * 3 + 1] * u[1] + Af[i * 3 + 2] * u[2];
+        Aw[i] = Af[i * 3] * w[0] + Af[i * 3 + 1] * w[1] + Af[i * 3 + 2] * w[2];
+        Av[i] = Af[i * 3] * v[0] + Af[i * 3 + 1] * v[1] + Af[i * 3 + 2] * v[2];
+    }
+
+    double muu = u[0] * Au[0] + u[1] * Au[1] + u[2] * Au[2];
+    double muw = u[0] * Aw[0] + u[1] * Aw[1] + u[2] * Aw[2];
+    double mww = w[0] * Aw[0] + w[1] * Aw[1] + w[2] * Aw[2];
+    double c = 1.0;
+    double s = 0.0;
+    double t = 0.0;
+
+    if (muw != 0.0) {
+        double theta = (mww - muu) / (2.0 * muw);
+        t = 1.0 / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+        t = theta < 0.0 ? -t : t;
+        c = 1.0 / std::sqrt(t * t + 1.0);
+        s = t * c;
+    }
+
+    for (size_t i = 0; i < 3; ++i) {
+        vec[i * 3] = v[i];
+        vec[i * 3 + 1] = c * u[i] - s * w[i];
+        vec[i * 3 + 2] = s * u[i] + c * w[i];
+    }
+
+    val[0] = v[0] * Av[0] + v[1] * Av[1] + v[2] * Av[2];
+    val[1] = muu - t * muw;
+    val[2] = mww + t * muw;
+
+    return eigs_accurate(A, vec, val);
+}
+
+/**
+Eigenvalue decomposition of a symmetric tensor by cyclic Jacobi rotations,
+starting from an approximate eigenbasis (e.g. the one of the previous iteration).
+If the guess is close, the rotated tensor is nearly diagonal and one or two sweeps suffice.
+\param A Symmetric tensor, packed [6].
+\param vec
+    Input: approximate eigenvectors, `vec[i * 3 + p]` is component `i` of eigenvector `p` [9].
+    Output: eigenvectors.
+\param val Output: eigenvalues [3].
+\return `true` if converged within #eigs_jacobi_sweeps and accurate, see eigs_accurate().
+*/
+inline bool eigs_jacobi(const double* A, double* vec, double* val)
+{
+    std::array<double, 9> Af;
+    std::array<double, 9> AV;
+    std::array<double, 9> D;
+    unpack(A, &Af[0]);
+
+    // re-orthonormalise the guess (Gram-Schmidt), to avoid accumulation of round-off
+    for (size_t p = 0; p < 3; ++p) {
+        for (size_t q = 0; q < p; ++q) {
+            double d = vec[q] * vec[p] + vec[3 + q] * vec[3 + p] + vec[6 + q] * vec[6 + p];
+            for (size_t i = 0; i < 3; ++i) {
+                vec[i * 3 + p] -= d * vec[i * 3 + q];
+            }
+        }
+        double n = std::sqrt(vec[p] * vec[p] + vec[3 + p] * vec[3 + p] + vec[6 + p] * vec[6 + p]);
+        if (!(n > 0.0)) {
+            return false;
+        }
+        for (size_t i = 0; i < 3; ++i) {
+            vec[i * 3 + p] /= n;
+        }
+    }
+
+    // "D = V^T . A . V"
+    dot(&Af[0], vec, &AV[0]);
+    for (size_t p = 0; p < 3; ++p) {
+        for (size_t q = 0; q < 3; ++q) {
+            D[p * 3 + q] = vec[p] * AV[q] + vec[3 + p] * AV[3 + q] + vec[6 + p] * AV[6 + q];
+        }
+    }
+
+    double norm = 0.0;
+    for (size_t i = 0; i < 9; ++i) {
+        norm += D[i] * D[i];
+    }
+
+    std::array<size_t, 3> P = {0, 0, 1};
+    std::array<size_t, 3> Q = {1, 2, 2};
+    bool converged = false;
+
+    for (size_t sweep = 0; sweep < eigs_jacobi_sweeps; ++sweep) {
+
+        double off = D[1] * D[1] + D[2] * D[2] + D[5] * D[5];
+
+        if (off <= 1e-4 * eigs_tol * eigs_tol * norm) {
+            converged = true;
+            break;
+        }
+
+        for (size_t r = 0; r < 3; ++r) {
+            size_t p = P[r];
+            size_t q = Q[r];
+            size_t k = 3 - p - q;
+            double dpq = D[p * 3 + q];
+
+            if (dpq == 0.0) {
+                continue;
+            }
+
+            double theta = (D[q * 3 + q] - D[p * 3 + p]) / (2.0 * dpq);
+            double t = 1.0 / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+            t = theta < 0.0 ? -t : t;
+            double c = 1.0 / std::sqrt(t * t + 1.0);
+            double s = t * c;
+
+            double dkp = D[k * 3 + p];
+            double dkq = D[k * 3 + q];
+            D[p * 3 + p] -= t * dpq;
+            D[q * 3 + q] += t * dpq;
+            D[p * 3 + q] = 0.0;
+            D[q * 3 + p] = 0.0;
+            D[k * 3 + p] = c * dkp - s * dkq;
+            D[p * 3 + k] = D[k * 3 + p];
+            D[k * 3 + q] = s * dkp + c * dkq;
+            D[q * 3 + k] = D[k * 3 + q];
+
+            for (size_t i = 0; i < 3; ++i) {
+                double vp = vec[i * 3 + p];
+                double vq = vec[i * 3 + q];
+                vec[i * 3 + p] = c * vp - s * vq;
+                vec[i * 3 + q] = s * vp + c * vq;
+            }
+        }
+    }
+
+    for (size_t p = 0; p < 3; ++p) {
+        val[p] = D[p * 3 + p];
+    }
+
+    return converged && eigs_accurate(A, vec, val);
+}
+
+/**
+Eigenvalue decomposition of a packed symmetric tensor, using a specific Eigensolver.
+If Eigensolver::Analytic or Eigensolver::Jacobi is not accurate,
+Eigensolver::Default is used instead.
+\param A Symmetric tensor, packed [6].
+\param vec Output: eigenvectors, `vec[i * 3 + p]` is component `i` of eigenvector `p` [9].
+\param val Output: eigenvalues [3].
+\param solver Eigensolver.
+\param cache
+    Eigenvectors of the previous decomposition [9] (read and updated for Eigensolver::Jacobi,
+    ignored otherwise).
+\return `true` if Eigensolver::Default had to be used as fallback.
+*/
+inline bool eigs_item(
+    const double* A,
+    double* vec,
+    double* val,
+    Eigensolver solver,
+    double* cache)
+{
+    if (solver == Eigensolver::Analytic) {
+        if (eigs_analytic(A, vec, val)) {
+            return false;
+        }
+    }
+    else if (solver == Eigensolver::Jacobi) {
+        std::copy(cache, cache + 9, vec);
+        if (eigs_jacobi(A, vec, val)) {
+            std::copy(vec, vec + 9, cache);
+            return false;
+        }
+    }
+
+    std::array<double, 9> Af;
+    unpack(A, &Af[0]);
+    GMatTensor::Cartesian3d::pointer::eigs(&Af[0], vec, val);
+
+    if (solver == Eigensolver::Jacobi) {
+        std::copy(vec, vec + 9, cache);
+    }
+
+    return solver != Eigensolver::Default;
+}
+
+/**
+Eigenvalue decomposition of packed symmetric tensors, item-by-item, see eigs_item().
+\param A Symmetric tensors, packed [6].
+\param vec Output: eigenvectors, `vec[i * 3 + p]` is component `i` of eigenvector `p` [9].
+\param val Output: eigenvalues [3].
+\param solver Eigensolver.
+\param cache
+    Eigenvectors of the previous decomposition of the first item, followed by those of the
+    other items [lanes<T>::size, 9] (only used for Eigensolver::Jacobi).
+\return Number of items for which Eigensolver::Default had to be used as fallback.
+*/
+template <class T>
+inline size_t eigs_packed(const T* A, T* vec, T* val, Eigensolver solver, double* cache)
+{
+    constexpr size_t W = lanes<T>::size;
+    std::array<double, 6 * W> a;
+    std::array<double, 9 * W> v;
+    std::array<double, 3 * W> l;
+    size_t ret = 0;
+
+    scatter(A, 6, 1, 6, &a[0]);
+
+    for (size_t w = 0; w < W; ++w) {
+        double* c = solver == Eigensolver::Jacobi ? &cache[w * 9] : nullptr;
+        if (eigs_item(&a[w * 6], &v[w * 9], &l[w * 3], solver, c)) {
+            ++ret;
+        }
+    }
+
+    gather(&v[0], 9, 1, 9, vec);
+    gather(&l[0], 3, 1, 3, val);
+
+    return ret;
+}
+
+/**
+`true` if compiled with `GMATELASTOPLASTICFINITESTRAINSIMO_ENABLE_INSTRUMENTATION`.
+*/
+constexpr bool instrumentation = GMATELASTOPLASTICFINITESTRAINSIMO_INSTRUMENTATION;
+
+/**
+Phases of the update of an item, see Instrumentation.
+*/
+enum class Phase : size_t {
+    Kinematics, ///< See Instrumentation::kinematics.
+    Eigs, ///< See Instrumentation::eigs.
+    Stress, ///< See Instrumentation::stress.
+    Tangent ///< See Instrumentation::tangent.
+};
+
+/**
+Counters of one thread, see Instrumentation.
+*/
+struct Counters {
+    std::array<double, 4> time = {}; ///< Time per Phase.
+    size_t items = 0; ///< See Instrumentation::items.
+    size_t yielded = 0; ///< See Instrumentation::yielded.
+    size_t degenerate = 0; ///< See Instrumentation::degenerate.
+    std::array<char, 64> padding; ///< Avoid that counters of different threads share a cache line.
+};
+
+/**
+Index of the current thread.
+\return Index.
+*/
+inline size_t thread_num()
+{
+#ifdef _OPENMP
+    return static_cast<size_t>(omp_get_thread_num());
+#else
+    return 0;
+#endif
+}
+
+/**
+Number of threads in the current parallel region.
+\return Number.
+*/
+inline size_t num_threads()
+{
+#ifdef _OPENMP
+    return static_cast<size_t>(omp_get_num_threads());
+#else
+    return 1;
+#endif
+}
+
+/**
+Maximal number of threads.
+\return Number.
+*/
+inline size_t max_threads()
+{
+#ifdef _OPENMP
+    return static_cast<size_t>(omp_get_max_threads());
+#else
+    return 1;
+#endif
+}
+
+/**
+Number of items per chunk of Schedule::Dynamic (rounded up to a multiple of the SIMD width).
+Chunks are small enough to balance a concentration of yielding items over the threads,
+and large enough to make the cost of scheduling negligible.
+*/
+constexpr size_t dynamic_chunk = 64;
+
+/**
+Number of chunks per thread used by Schedule::Balanced to estimate the cost of the items.
+*/
+constexpr size_t balance_chunks = 64;
+
+/**
+First item of the block of a thread, if `n` items are divided in `nthreads` contiguous blocks
+of (nearly) equal size.
+The boundaries of the blocks are multiples of `align`,
+such that batches of `align` items are not split over threads.
+\param n Number of items.
+\param align Alignment of the boundaries (e.g. `lanes<T>::size`).
+\param thread Index of the thread (`nthreads` gives `n`).
+\param nthreads Number of threads.
+\return Index of the first item.
+*/
+inline size_t block_begin(size_t n, size_t align, size_t thread, size_t nthreads)
+{
+    size_t nblock = (n + align - 1) / align;
+    return std::min(n, nblock * thread / nthreads * align);
+}
+
+/**
+Record the phases of the update of `lanes<T>::size` items in the Counters of the current thread.
+Does nothing if there are no counters (i.e. if compiled without instrumentation).
+*/
+class Stopwatch {
+public:
+    /**
+    Start timing.
+    \param counters Counters of the current thread (`nullptr` to not record).
+    */
+    explicit Stopwatch(Counters* counters) : m_counters(counters)
+    {
+        if (instrumentation && m_counters) {
+            m_tic = std::chrono::steady_clock::now();
+        }
+    }
+
+    /**
+    Add the time since the start (or the previous lap) to a phase.
+    \param phase Phase.
+    */
+    void lap(Phase phase)
+    {
+        if (instrumentation && m_counters) {
+            auto toc = std::chrono::steady_clock::now();
+            m_counters->time[static_cast<size_t>(phase)] +=
+                std::chrono::duration<double>(toc - m_tic).count();
+            m_tic = toc;
+        }
+    }
+
+    /**
+    Count updated items, and the items that yielded.
+    \param dgamma Plastic strain increment of each item (zero if elastic).
+    */
+    template <class T>
+    void count(const T& dgamma)
+    {
+        if (instrumentation && m_counters) {
+            std::array<double, lanes<T>::size> value;
+            lanes<T>::store(dgamma, &value[0]);
+            for (size_t w = 0; w < lanes<T>::size; ++w) {
+                m_counters->yielded += value[w] > 0.0;
+            }
+            m_counters->items += lanes<T>::size;
+        }
+    }
+
+    /**
+    Count the pairs of equal eigenvalues (for which the tangent uses the limit of dlog()).
+    \param val Eigenvalues [3].
+    */
+    void count_degenerate(const double* val)
+    {
+        if (instrumentation && m_counters) {
+            m_counters->degenerate += (val[0] == val[1]) + (val[0] == val[2]) + (val[1] == val[2]);
+        }
+    }
+
+private:
+    Counters* m_counters; ///< Counters of the current thread.
+    std::chrono::steady_clock::time_point m_tic; ///< Start of the current phase.
+};
+
+/**
+Sum the counters of all threads.
+\param counters Counters per thread.
+\return Instrumentation.
+*/
+inline Instrumentation sum_counters(const std::vector<Counters>& counters)
+{
+    Instrumentation ret;
+    ret.enabled = instrumentation;
+
+    for (auto& c : counters) {
+        ret.kinematics += c.time[static_cast<size_t>(Phase::Kinematics)];
+        ret.eigs += c.time[static_cast<size_t>(Phase::Eigs)];
+        ret.stress += c.time[static_cast<size_t>(Phase::Stress)];
+        ret.tangent += c.time[static_cast<size_t>(Phase::Tangent)];
+        ret.items += c.items;
+        ret.yielded += c.yielded;
+        ret.degenerate += c.degenerate;
+        ret.thread_items.push_back(c.items);
+        ret.thread_yielded.push_back(c.yielded);
+        ret.thread_time.push_back(c.time[0] + c.time[1] + c.time[2] + c.time[3]);
+    }
+
+    return ret;
+}
+
+/**
+Store which of `lanes<T>::size` consecutive values are positive.
+\param value Values.
+\param ret Output: `value > 0` per item [lanes<T>::size].
+*/
+template <class T>
+inline void store_positive(const T& value, bool* ret)
+{
+    std::array<double, lanes<T>::size> v;
+    lanes<T>::store(value, &v[0]);
+    for (size_t w = 0; w < lanes<T>::size; ++w) {
+        ret[w] = v[w] > 0.0;
+    }
+}
+
+/**
+Check if an output is requested.
+\param flags Requested outputs.
+\param flag Output to check.
+\return `true` if `flag` is in `flags`.
+*/
+inline bool has_output(Output flags, Output flag)
+{
+    return (flags & flag) != Output::None;
+}
+
+/**
+Norm of the deviatoric part of a symmetric tensor, from its eigenvalues:
+\f$ \sqrt{ \sum_p (\lambda_p - \bar{\lambda})^2 } \f$ with \f$ \bar{\lambda} \f$ their mean.
+\param val Eigenvalues [3].
+\return Norm.
+*/
+template <class T>
+inline T norm_deviatoric(const T* val)
+{
+    using std::sqrt;
+
+    T m = (val[0] + val[1] + val[2]) / 3.0;
+    T d0 = val[0] - m;
+    T d1 = val[1] - m;
+    T d2 = val[2] - m;
+    return sqrt(d0 * d0 + d1 * d1 + d2 * d2);
+}
+
+/**
+Elastic energy stored per unit reference volume (Hencky):
+\f$ \frac{9}{2} K \varepsilon_m^2 + G \, \varepsilon_d : \varepsilon_d \f$.
+\param K Bulk modulus.
+\param G Shear modulus.
+\param Eps_val Eigenvalues of the elastic logarithmic strain [3].
+\return Energy.
+*/
+template <class T>
+inline T elastic_energy(const T& K, const T& G, const T* Eps_val)
+{
+    T epsm = (Eps_val[0] + Eps_val[1] + Eps_val[2]) / 3.0;
+    T epsd = norm_deviatoric(Eps_val);
+    return 4.5 * K * epsm * epsm + G * epsd * epsd;
+}
+
+/**
+Elastic stress response, evaluated in the eigenbasis of the elastic Finger tensor "Be".
+\param K Bulk modulus.
+\param G Shear modulus.
+\param J Volume change ratio.
+\param vec Eigenvectors of "Be": `vec[i * 3 + p]` is component `i` of eigenvector `p`.
+\param Be_val Eigenvalues of "Be" [3].
+\param Eps_val Output: eigenvalues of the logarithmic strain [3].
+\param Sig_val Output: eigenvalues of the Cauchy stress [3].
+\param Sig Output: Cauchy stress, packed [6].
+*/
+template <class T>
+inline void elastic_stress(
+    const T& K,
+    const T& G,
+    const T& J,
+    const T* vec,
+    const T* Be_val,
+    T* Eps_val,
+    T* Sig_val,
+    T* Sig)
+{
+    using std::log;
+
+    // logarithmic strain "Eps := 0.5 ln(Be)" (in diagonalised form)
+    for (size_t j = 0; j < 3; ++j) {
+        Eps_val[j] = 0.5 * log(Be_val[j]);
+    }
+
+    // decompose strain (in diagonalised form)
+    T epsm = (Eps_val[0] + Eps_val[1] + Eps_val[2]) / 3.0;
+
+    // Cauchy stress (in diagonalised form)
+    for (size_t j = 0; j < 3; ++j) {
+        Sig_val[j] = (3.0 * K * epsm + 2.0 * G * (Eps_val[j] - epsm)) / J;
+    }
+
+    // Cauchy stress, in original coordinate frame
+    from_eigs_packed(vec, Sig_val, Sig);
+}
+
+/**
+Return map of the linear hardening model, evaluated in the eigenbasis of the trial elastic
+Finger tensor "Be_trial".
+The return map is branch-free: the plastic correction is masked to the plastic items,
+such that a batch of items is evaluated in lockstep.
+\param K Bulk modulus.
+\param G Shear modulus.
+\param tauy0 Initial yield stress.
+\param H Hardening modulus.
+\param M Denominator of the return map, `3 G + H` (see plastic_modulus()).
+\param epsp_t Plastic strain at the previous increment.
+\param J Volume change ratio.
+\param Be_trial Trial elastic Finger tensor, packed [6].
+\param vec Eigenvectors of "Be_trial": `vec[i * 3 + p]` is component `i` of eigenvector `p`.
+\param Be_trial_val Eigenvalues of "Be_trial" [3].
+\param Be Output: elastic Finger tensor, packed [6].
+\param Sig Output: Cauchy stress, packed [6].
+\param Epse_val Output: eigenvalues of the elastic logarithmic strain (after the return map) [3].
+\param Sig_val Output: eigenvalues of the Cauchy stress [3].
+\param N_val Output: eigenvalues of the direction of plastic flow [3] (zero if elastic).
+\param dgamma Output: plastic strain increment (zero if elastic).
+\param taueq Output: trial equivalent Kirchhoff stress.
+*/
+template <class T>
+inline void linear_hardening_stress(
+    const T& K,
+    const T& G,
+    const T& tauy0,
+    const T& H,
+    const T& M,
+    const T& epsp_t,
+    const T& J,
+    const T* Be_trial,
+    const T* vec,
+    const T* Be_trial_val,
+    T* Be,
+    T* Sig,
+    T* Epse_val,
+    T* Sig_val,
+    T* N_val,
+    T& dgamma,
+    T& taueq)
+{
+    using std::exp;
+    using std::log;
+    using std::sqrt;
+
+    // logarithmic strain "Eps := 0.5 ln(Be)" (in diagonalised form)
+    for (size_t j = 0; j < 3; ++j) {
+        Epse_val[j] = 0.5 * log(Be_trial_val[j]);
+    }
+
+    // decomposed trial (equivalent) Kirchhoff stress (in diagonalised form)
+    std::array<T, 3> Taud_val;
+    T epsem = (Epse_val[0] + Epse_val[1] + Epse_val[2]) / 3.0;
+    T taum = 3.0 * K * epsem;
+    for (size_t j = 0; j < 3; ++j) {
+        Taud_val[j] = 2.0 * G * (Epse_val[j] - epsem);
+    }
+    taueq = sqrt(
+        1.5 * (Taud_val[0] * Taud_val[0] + Taud_val[1] * Taud_val[1] + Taud_val[2] * Taud_val[2]));
+
+    // evaluate the yield surface
+    T phi = taueq - (tauy0 + H * epsp_t);
+    auto plastic = phi > T(0.0);
+
+    // return map: plastic flow and update of the deviatoric trial stress (masked)
+    dgamma = select(plastic, phi / M, T(0.0));
+    T scale = select(plastic, 1.0 - 3.0 * G * dgamma / taueq, T(1.0));
+    for (size_t j = 0; j < 3; ++j) {
+        N_val[j] = select(plastic, 1.5 * Taud_val[j] / taueq, T(0.0));
+        Taud_val[j] *= scale;
+        Epse_val[j] -= dgamma * N_val[j];
+    }
+
+    // elastic Finger tensor, in original coordinate frame ("Be = Be_trial" if elastic)
+    for (size_t I = 0; I < 6; ++I) {
+        Be[I] = Be_trial[I];
+    }
+
+    if (any(plastic)) {
+        std::array<T, 3> Be_val;
+        std::array<T, 6> Be_plastic;
+        for (size_t j = 0; j < 3; ++j) {
+            Be_val[j] = exp(2.0 * (epsem + Taud_val[j] / (2.0 * G)));
+        }
+        from_eigs_packed(vec, &Be_val[0], &Be_plastic[0]);
+        for (size_t I = 0; I < 6; ++I) {
+            Be[I] = select(plastic, Be_plastic[I], Be_trial[I]);
+        }
+    }
+
+    // Cauchy stress, in original coordinate frame
+    for (size_t j = 0; j < 3; ++j) {
+        Sig_val[j] = (taum + Taud_val[j]) / J;
+    }
+    from_eigs_packed(vec, Sig_val, Sig);
+}
+
+/**
+Weight of each component in Mandel notation: 1 on the diagonal, \f$ \sqrt{2} \f$ otherwise.
+\param I Mandel index.
+\return Weight.
+*/
+inline double mandel_weight(size_t I)
+{
+    return I < 3 ? 1.0 : std::sqrt(2.0);
+}
+
+/**
+Geometric part of the tangent that is not captured by its symmetric part:
+
+    R_ijkl = - 0.5 * (delta_ik Sig_jl + Sig_ik delta_jl + delta_il Sig_jk - Sig_il delta_jk)
+
+\param Sig Cauchy stress [3, 3].
+\param i Index.
+\param j Index.
+\param k Index.
+\param l Index.
+\return Component.
+*/
+inline double tangent_stress_part(const double* Sig, size_t i, size_t j, size_t k, size_t l)
+{
+    double ret = 0.0;
+
+    if (i == k) {
+        ret -= Sig[j * 3 + l];
+    }
+    if (j == l) {
+        ret -= Sig[i * 3 + k];
+    }
+    if (i == l) {
+        ret -= Sig[j * 3 + k];
+    }
+    if (j == k) {
+        ret += Sig[i * 3 + l];
+    }
+
+    return 0.5 * ret;
+}
+
+/**
+Symmetric part of the consistent tangent in Mandel notation, assembled from the same spectral
+coefficients as spectral_tangent() without forming the full tangent.
+The symmetric part has in the eigenbasis of "Be" the components
+
+    Cs_ppqq = 2 * (a + b * delta_pq + c * N_p * N_q) / J
+    Cs_pqpq = Cs_pqqp = b * (Be_p + Be_q) / 2 * (ln(Be_q) - ln(Be_p)) / (Be_q - Be_p) / J
+
+while the full tangent follows as `C = Cs + R` with `R` given by tangent_stress_part().
+
+\param vec Eigenvectors of "Be": `vec[i * 3 + p]` is component `i` of eigenvector `p`.
+\param Be_val Eigenvalues of "Be" [3].
+\param N_val Eigenvalues of "N" [3] (only read if `c != 0`).
+\param a Coefficient of "II".
+\param b Coefficient of "I4s".
+\param c Coefficient of "N x N".
+\param J Volume change ratio.
+\param ret Output: symmetric part of the tangent in Mandel notation [6, 6] (stored as `U`).
+*/
+template <class U>
+inline void spectral_tangent_mandel(
+    const double* vec,
+    const double* Be_val,
+    const double* N_val,
+    double a,
+    double b,
+    double c,
+    double J,
+    U* ret)
+{
+    // Mandel vectors of "v_p x v_p" and of "sym(v_p x v_q)" for the pairs (0, 1), (0, 2), (1, 2)
+    std::array<size_t, 3> P = {0, 0, 1};
+    std::array<size_t, 3> R = {1, 2, 2};
+    std::array<double, 18> Vpp;
+    std::array<double, 18> Vpq;
+
+    for (size_t I = 0; I < 6; ++I) {
+        size_t i = mandel_i[I];
+        size_t j = mandel_j[I];
+        double w = mandel_weight(I);
+        for (size_t p = 0; p < 3; ++p) {
+            Vpp[p * 6 + I] = w * vec[i * 3 + p] * vec[j * 3 + p];
+        }
+        for (size_t r = 0; r < 3; ++r) {
+            size_t p = P[r];
+            size_t q = R[r];
+            Vpq[r * 6 + I] =
+                0.5 * w * (vec[i * 3 + p] * vec[j * 3 + q] + vec[i * 3 + q] * vec[j * 3 + p]);
+        }
+    }
+
+    std::array<double, 9> D;
+    std::array<double, 3> S;
+
+    for (size_t p = 0; p < 3; ++p) {
+        for (size_t q = 0; q < 3; ++q) {
+            D[p * 3 + q] = 2.0 * a / J;
+            if (c != 0.0) {
+                D[p * 3 + q] += 2.0 * c * N_val[p] * N_val[q] / J;
+            }
+            if (p == q) {
+                D[p * 3 + q] += 2.0 * b / J;
+            }
+        }
+    }
+
+    // factor four: "(v_p x v_q + v_q x v_p) = 2 sym(v_p x v_q)" on both sides
+    for (size_t r = 0; r < 3; ++r) {
+        double Bp = Be_val[P[r]];
+        double Bq = Be_val[R[r]];
+        S[r] = 2.0 * b * (Bp + Bq) * dlog(Bp, Bq) / J;
+    }
+
+    for (size_t I = 0; I < 6; ++I) {
+        for (size_t K = I; K < 6; ++K) {
+            double val = 0.0;
+            for (size_t p = 0; p < 3; ++p) {
+                for (size_t q = 0; q < 3; ++q) {
+                    val += D[p * 3 + q] * Vpp[p * 6 + I] * Vpp[q * 6 + K];
+                }
+            }
+            for (size_t r = 0; r < 3; ++r) {
+                val += S[r] * Vpq[r * 6 + I] * Vpq[r * 6 + K];
+            }
+            ret[I * 6 + K] = static_cast<U>(val);
+            ret[K * 6 + I] = static_cast<U>(val);
+        }
+    }
+}
+
+/**
+Full tangent from its symmetric part in Mandel notation and the Cauchy stress.
+\param M Symmetric part of the tangent in Mandel notation [6, 6].
+\param Sig Cauchy stress [3, 3].
+\param C Output: tangent [3, 3, 3, 3].
+*/
+template <class U>
+inline void mandel_to_tangent(const U* M, const double* Sig, U* C)
+{
+    std::array<size_t, 9> idx = {0, 5, 4, 5, 1, 3, 4, 3, 2};
+
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            size_t I = idx[i * 3 + j];
+            for (size_t k = 0; k < 3; ++k) {
+                for (size_t l = 0; l < 3; ++l) {
+                    size_t K = idx[k * 3 + l];
+                    C[i * 27 + j * 9 + k * 3 + l] = static_cast<U>(
+                        M[I * 6 + K] / (mandel_weight(I) * mandel_weight(K)) +
+                        tangent_stress_part(Sig, i, j, k, l));
+                }
+            }
+        }
+    }
+}
+
+/**
+Symmetric part of a tangent in Mandel notation (inverse of mandel_to_tangent()).
+\param C Tangent [3, 3, 3, 3].
+\param Sig Cauchy stress [3, 3].
+\param M Output: symmetric part of the tangent in Mandel notation [6, 6].
+*/
+template <class U>
+inline void tangent_to_mandel(const U* C, const double* Sig, U* M)
+{
+    for (size_t I = 0; I < 6; ++I) {
+        size_t i = mandel_i[I];
+        size_t j = mandel_j[I];
+        for (size_t K = 0; K < 6; ++K) {
+            size_t k = mandel_i[K];
+            size_t l = mandel_j[K];
+            M[I * 6 + K] = static_cast<U>(
+                mandel_weight(I) * mandel_weight(K) *
+                (C[i * 27 + j * 9 + k * 3 + l] - tangent_stress_part(Sig, i, j, k, l)));
+        }
+    }
+}
+
+/**
+Add the contribution of one integration point to the internal force and the stiffness of an
+element (i.e. the contractions of e.g. GooseFEM's `Int_gradN_dot_tensor2_dV` and
+`Int_gradN_dot_tensor4_dot_gradNT_dV`):
+
+    fe[a * 3 + d] += dNdx[a, c] * Sig[c, d] * dV
+    Ke[a * 3 + d, b * 3 + e] += dNdx[a, c] * C[c, d, e, f] * dNdx[b, f] * dV
+
+\param nne Number of nodes per element.
+\param dNdx Shape function gradients [nne, 3].
+\param dV Integration weight (volume) of the integration point.
+\param Sig Cauchy stress [3, 3].
+\param C Tangent [3, 3, 3, 3].
+\param fe Internal force [nne * 3] (added to).
+\param Ke Stiffness [nne * 3, nne * 3] (added to).
+*/
+inline void element_contract(
+    size_t nne,
+    const double* dNdx,
+    double dV,
+    const double* Sig,
+    const double* C,
+    double* fe,
+    double* Ke)
+{
+    size_t n = nne * 3;
+
+    for (size_t a = 0; a < nne; ++a) {
+        for (size_t d = 0; d < 3; ++d) {
+            double f = 0.0;
+            for (size_t c = 0; c < 3; ++c) {
+                f += dNdx[a * 3 + c] * Sig[c * 3 + d];
+            }
+            fe[a * 3 + d] += f * dV;
+        }
+    }
+
+    // "D[c, d, b, e] = C[c, d, e, f] * dNdx[b, f] * dV" for one node "b" at a time
+    std::array<double, 27> D;
+
+    for (size_t b = 0; b < nne; ++b) {
+        for (size_t cd = 0; cd < 9; ++cd) {
+            for (size_t e = 0; e < 3; ++e) {
+                double v = 0.0;
+                for (size_t f = 0; f < 3; ++f) {
+                    v += C[cd * 9 + e * 3 + f] * dNdx[b * 3 + f];
+                }
+                D[cd * 3 + e] = v * dV;
+            }
+        }
+        for (size_t a = 0; a < nne; ++a) {
+            for (size_t d = 0; d < 3; ++d) {
+                for (size_t e = 0; e < 3; ++e) {
+                    double v = 0.0;
+                    for (size_t c = 0; c < 3; ++c) {
+                        v += dNdx[a * 3 + c] * D[(c * 3 + d) * 3 + e];
+                    }
+                    Ke[(a * 3 + d) * n + b * 3 + e] += v;
+                }
+            }
+        }
+    }
+}
+
+/**
+Contraction of the first Piola-Kirchhoff stress with a variation of the deformation gradient:
+`P : dF = J * Sig : (dF . inv(F))` (with `P = J * Sig . inv(F)^T`).
+\param J Volume change ratio `det(F)`.
+\param Sig Cauchy stress [3, 3].
+\param F Deformation gradient tensor [3, 3].
+\param dF Variation of the deformation gradient tensor [3, 3].
+\return `P : dF`.
+*/
+template <class T>
+inline T piola_contract(const T& J, const T* Sig, const T* F, const T* dF)
+{
+    std::array<T, 9> Finv;
+    std::array<T, 9> L;
+    inv(F, &Finv[0]);
+    dot(dF, &Finv[0], &L[0]);
+
+    T ret = Sig[0] * L[0];
+    for (size_t k = 1; k < 9; ++k) {
+        ret += Sig[k] * L[k];
+    }
+
+    return J * ret;
+}
+
+/**
+Scaled norm of the deviator of each item of an array of second-order tensors
+(see Epseq() and Sigeq()), evaluated in a single (parallel) pass.
+\param A [..., 3, 3] array.
+\param ret Output: [...] array.
+\param factor Scale factor.
+*/
+template <class T, class U>
+inline void norm_deviatoric(const T& A, U& ret, double factor)
+{
+    size_t n = ret.size();
+
+#pragma omp parallel for if (n >= GMATELASTOPLASTICFINITESTRAINSIMO_PARALLEL_MIN_SIZE)
+    for (size_t i = 0; i < n; ++i) {
+        ret.flat(i) = factor * GMatTensor::Cartesian3d::pointer::Norm_deviatoric(&A.flat(i * 9));
+    }
+}
+
+/**
+Logarithmic strain `0.5 * ln(F . F^T)` of each item of an array of deformation gradient tensors
+(see Strain()), evaluated in a single (parallel) pass:
+the Finger tensor, its eigenvalue decomposition, and the logarithm of its eigenvalues
+are computed item-by-item on the stack.
+\param A [..., 3, 3] array.
+\param ret Output: [..., 3, 3] array (may be `A`).
+*/
+template <class T, class U>
+inline void strain(const T& A, U& ret)
+{
+    size_t n = A.size() / 9;
+
+#pragma omp parallel for if (n >= GMATELASTOPLASTICFINITESTRAINSIMO_PARALLEL_MIN_SIZE)
+    for (size_t i = 0; i < n; ++i) {
+        std::array<double, 9> F;
+        std::array<double, 6> B;
+        std::array<double, 9> vec;
+        std::array<double, 3> val;
+        std::array<double, 6> Eps;
+
+        std::copy(&A.flat(i * 9), &A.flat(i * 9) + 9, F.begin());
+        dot_transpose_packed(&F[0], &B[0]);
+        eigs_item(&B[0], &vec[0], &val[0], Eigensolver::Default, nullptr);
+        for (size_t j = 0; j < 3; ++j) {
+            val[j] = 0.5 * std::log(val[j]);
+        }
+        from_eigs_packed(&vec[0], &val[0], &Eps[0]);
+        unpack(&Eps[0], &ret.flat(i * 9));
+    }
+}
+
+} // namespace detail
+
+/**
+Von Mises equivalent strain: norm of strain deviator
+
+\f$ \sqrt{\frac{2}{3} (dev(A))_{ij} (dev(A))_{ji}} \f$
+
+To write to allocated data use epseq().
+
+\param A [..., 3, 3] array.
+\return [...] array.
+*/
+template <class T>
+inline auto Epseq(const T& A) -> typename GMatTensor::allocate<xt::get_rank<T>::value - 2, T>::type
+{
+    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.dimension() >= 2);
+    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.shape(A.dimension() - 1) == 3);
+    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.shape(A.dimension() - 2) == 3);
+
+    using return_type = typename GMatTensor::allocate<xt::get_rank<T>::value - 2, T>::type;
+    std::array<size_t, xt::get_rank<T>::value - 2> shape;
+    std::copy(A.shape().cbegin(), A.shape().cend() - 2, shape.begin());
+    return_type ret = return_type::from_shape(shape);
+    detail::norm_deviatoric(A, ret, std::sqrt(2.0 / 3.0));
+    return ret;
+}
+
+/**
+Same as epseq(), but writes to externally allocated output.
+
+\param A [..., 3, 3] array.
+\param ret output [...] array
+*/
+template <class T, class U>
+inline void epseq(const T& A, U& ret)
+{
+    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.dimension() >= 2);
+    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.shape(A.dimension() - 1) == 3);
+    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.shape(A.dimension() - 2) == 3);
+    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.size() == ret.size() * 9);
+
+    detail::norm_deviatoric(A, ret, std::sqrt(2.0 / 3.0));
+}
+
+/**
+Von Mises equivalent stress: norm of strain deviator
+
+\f$ \sqrt{\frac{3}{2} (dev(A))_{ij} (dev(A))_{ji}} \f$
+
+To write to allocated data use sigeq().
+
+\param A [..., 3, 3] array.
+\return [...] array.
+*/
+template <class T>
+inline auto Sigeq(const T& A) -> typename GMatTensor::allocate<xt::get_rank<T>::value - 2, T>::type
+{
+    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.dimension() >= 2);
+    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.shape(A.dimension() - 1) == 3);
+    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.shape(A.dimension() - 2) == 3);
+
+    using return_type = typename GMatTensor::allocate<xt::get_rank<T>::value - 2, T>::type;
+    std::array<size_t, xt::get_rank<T>::value - 2> shape;
+    std::copy(A.shape().cbegin(), A.shape().cend() - 2, shape.begin());
+    return_type ret = return_type::from_shape(shape);
+    detail::norm_deviatoric(A, ret, std::sqrt(1.5));
+    return ret;
+}
+
+/**
+Same as Sigeq(), but writes to externally allocated output.
+
+\param A [..., 3, 3] array.
+\param ret output [...] array
+*/
+template <class T, class U>
+inline void sigeq(const T& A, U& ret)
+{
+    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.dimension() >= 2);
+    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.shape(A.dimension() - 1) == 3);
+    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.shape(A.dimension() - 2) == 3);
+    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.size() == ret.size() * 9);
+
+    detail::norm_deviatoric(A, ret, std::sqrt(1.5));
+}
+
+// Deformation gradient tensor -> strain = 0.5 * ln(B), B = F . F^T
+
+/**
+Strain tensor from deformation gradient tensor:
+
+\f$ \ln(\bm{B}) / 2 \f$
+
+with
+
+\f$ \bm{B} = \bm{F} \cdot \bm{F}^T \f$
+
+To write to allocated data use strain().
+
+\param A [..., 3, 3] array.
+\return [...] array.
+*/
+template <class T>
+inline auto Strain(const T& A) -> typename GMatTensor::allocate<xt::get_rank<T>::value, T>::type
+{
+    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.dimension() >= 2);
+    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.shape(A.dimension() - 1) == 3);
+    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.shape(A.dimension() - 2) == 3);
+
+    using return_type = typename GMatTensor::allocate<xt::get_rank<T>::value, T>::type;
+    return_type ret = return_type::from_shape(A.shape());
+    detail::strain(A, ret);
+    return ret;
+}
+
+/**
+Same as Strain(), but writes to externally allocated output.
+
+\param A [..., 3, 3] array.
+\param ret output [...] array
+*/
+template <class T, class U>
+inline void strain(const T& A, U& ret)
+{
+    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.dimension() >= 2);
+    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.shape(A.dimension() - 1) == 3);
+    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.shape(A.dimension() - 2) == 3);
+    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(xt::has_shape(A, ret.shape()));
+
+    detail::strain(A, ret);
+}
+
+/**
+Stateless evaluation of one material point on raw pointers,
+e.g. to evaluate the constitutive response inline in an element loop.
+All tensors are stored row-major: [3, 3] and [3, 3, 3, 3].
+Eigensolver::Jacobi is replaced by Eigensolver::Analytic,
+as there is no previous eigenbasis to start from.
+*/
+namespace pointer {
+
+/**
+Stress (and tangent) of the elastic model, see Elastic.
+\param K Bulk modulus.
+\param G Shear modulus.
+\param F Deformation gradient tensor [3, 3].
+\param Sig Output: Cauchy stress [3, 3].
+\param C Output: tangent [3, 3, 3, 3] (not computed if `nullptr`).
+\param solver Eigensolver (Eigensolver::Jacobi is replaced by Eigensolver::Analytic).
+*/
+inline void elastic_stress_tangent(
+    double K,
+    double G,
+    const double* F,
+    double* Sig,
+    double* C = nullptr,
+    Eigensolver solver = Eigensolver::Default)
+{
+    if (solver == Eigensolver::Jacobi) {
+        solver = Eigensolver::Analytic;
+    }
+
+    std::array<double, 9> vec;
+    std::array<double, 3> Be_val;
+    std::array<double, 3> Eps_val;
+    std::array<double, 3> Sig_val;
+    std::array<double, 6> Be;
+    std::array<double, 6> Sig_packed;
+
+    double J = detail::det(F);
+    detail::dot_transpose_packed(F, &Be[0]);
+    detail::eigs_item(&Be[0], &vec[0], &Be_val[0], solver, nullptr);
+    detail::elastic_stress(
+        K, G, J, &vec[0], &Be_val[0], &Eps_val[0], &Sig_val[0], &Sig_packed[0]);
+    detail::unpack(&Sig_packed[0], Sig);
+
+    if (C) {
+        detail::spectral_tangent(
+            &vec[0], &Be_val[0], &Sig_val[0], nullptr, 0.5 * K - G / 3.0, G, 0.0, J, C);
+    }
+}
+
+/**
+History of the linear hardening model that does not depend on the current deformation:
+the inverse of the plastic right Cauchy-Green tensor `inv(Cp_t) = inv(F_t) . Be_t . inv(F_t)^T`.
+Evaluate it once per increment, see LinearHardening::increment().
+\param F_t Deformation gradient tensor at the end of the previous increment [3, 3].
+\param Be_t Elastic Finger tensor at the end of the previous increment [3, 3].
+\param Cpinv_t Output: `inv(Cp_t)` [3, 3].
+*/
+inline void linear_hardening_history(const double* F_t, const double* Be_t, double* Cpinv_t)
+{
+    std::array<double, 9> Finv_t;
+    std::array<double, 6> Be_t_packed;
+    std::array<double, 6> Cpinv_t_packed;
+
+    detail::inv(F_t, &Finv_t[0]);
+    detail::pack(Be_t, &Be_t_packed[0]);
+    detail::push_forward_packed(&Finv_t[0], &Be_t_packed[0], &Cpinv_t_packed[0]);
+    detail::unpack(&Cpinv_t_packed[0], Cpinv_t);
+}
+
+/**
+Stress (and tangent) of the linear hardening model, see LinearHardening.
+\param K Bulk modulus.
+\param G Shear modulus.
+\param tauy0 Initial yield stress.
+\param H Hardening modulus.
+\param F Deformation gradient tensor [3, 3].
+\param Cpinv_t History: see linear_hardening_history() [3, 3].
+\param epsp_t History: plastic strain at the end of the previous increment.
+\param Sig Output: Cauchy stress [3, 3].
+\param Be Output: elastic Finger tensor [3, 3].
+\param epsp Output: plastic strain.
+\param C Output: tangent [3, 3, 3, 3] (not computed if `nullptr`).
+\param solver Eigensolver (Eigensolver::Jacobi is replaced by Eigensolver::Analytic).
+*/
+inline void linear_hardening_stress_tangent(
+    double K,
+    double G,
+    double tauy0,
+    double H,
+    const double* F,
+    const double* Cpinv_t,
+    double epsp_t,
+    double* Sig,
+    double* Be,
+    double& epsp,
+    double* C = nullptr,
+    Eigensolver solver = Eigensolver::Default)
+{
+    if (solver == Eigensolver::Jacobi) {
+        solver = Eigensolver::Analytic;
+    }
+
+    double dgamma;
+    double taueq;
+    std::array<double, 9> vec;
+    std::array<double, 3> Be_trial_val;
+    std::array<double, 3> Epse_val;
+    std::array<double, 3> Sig_val;
+    std::array<double, 3> N_val;
+    std::array<double, 6> Cpinv_t_packed;
+    std::array<double, 6> Be_trial;
+    std::array<double, 6> Be_packed;
+    std::array<double, 6> Sig_packed;
+
+    double J = detail::det(F);
+    detail::pack(Cpinv_t, &Cpinv_t_packed[0]);
+    detail::push_forward_packed(F, &Cpinv_t_packed[0], &Be_trial[0]);
+    detail::eigs_item(&Be_trial[0], &vec[0], &Be_trial_val[0], solver, nullptr);
+
+    double M = 3.0 * G + H;
+    detail::linear_hardening_stress(
+        K,
+        G,
+        tauy0,
+        H,
+        M,
+        epsp_t,
+        J,
+        &Be_trial[0],
+        &vec[0],
+        &Be_trial_val[0],
+        &Be_packed[0],
+        &Sig_packed[0],
+        &Epse_val[0],
+        &Sig_val[0],
+        &N_val[0],
+        dgamma,
+        taueq);
+
+    epsp = epsp_t + dgamma;
+    detail::unpack(&Sig_packed[0], Sig);
+    detail::unpack(&Be_packed[0], Be);
+
+    if (C) {
+        double a;
+        double b;
+        double c;
+        detail::linear_hardening_tangent(K, G, M, dgamma, taueq, a, b, c);
+        detail::spectral_tangent(
+            &vec[0], &Be_trial_val[0], &Sig_val[0], &N_val[0], a, b, c, J, C);
+    }
+}
+
+} // namespace pointer
+
+/**
+Array of material points: the state and the functions that are common to Elastic and
+LinearHardening (parameters, tangent storage and policy, layout, schedule, derived outputs).
+The constitutive response is implemented by the derived class `D` (static polymorphism),
+which provides:
+
+-   `F()` and `Sig_packed()`: the current deformation gradient and stress.
+-   `refresh_items<T>(s, i)`: update the stress of `detail::lanes<T>::size` consecutive items.
+-   `refresh_tangent(s, i, mandel, C)`: update the stress and the tangent of one item.
+-   `evaluate_trial_items<T>(s, i, F, dF, Sig, work)`: the stress for a candidate "F".
+-   Optionally `begin_update(all)`, `relayout_state(stride_item, stride_comp)`, and `balance()`
+    if it stores more state or if its items differ in cost
+    (see begin_update(), relayout_state(), and balance()).
+
+\tparam D Derived class.
+\tparam N Rank of the array.
+\tparam Tangent Scalar type in which the tangent is stored, see Elastic.
+*/
+template <class D, size_t N, class Tangent>
+class ArrayBase : public GMatTensor::Cartesian3d::Array<N> {
+protected:
+    ParameterStorage m_parameter_storage = ParameterStorage::Item; ///< Storage of #m_K, ...
+    array_type::tensor<double, N> m_K; ///< Bulk modulus per item (ParameterStorage::Item).
+    array_type::tensor<double, N> m_G; ///< Shear modulus per item (ParameterStorage::Item).
+    array_type::tensor<size_t, N> m_phase; ///< Phase per item (ParameterStorage::Phase).
+    array_type::tensor<double, 1> m_K_table; ///< Bulk modulus per phase (or of all items).
+    array_type::tensor<double, 1> m_G_table; ///< Shear modulus per phase (or of all items).
+    array_type::tensor<double, N + 2> m_F; ///< Deformation gradient tensor per item.
+    array_type::tensor<double, N + 1> m_Sig; ///< Cauchy stress tensor per item (packed).
+    array_type::tensor<Tangent, N + 4> m_C; ///< Tangent per item (allocated when first computed).
+    array_type::tensor<Tangent, N + 2> m_C_mandel; ///< Symmetric part of tangent (Mandel) per item.
+    array_type::tensor<double, N + 1> m_Sig_tangent; ///< Stress of a kept tangent: [shape(), 6].
+    TangentStorage m_tangent_storage = TangentStorage::Full; ///< Storage used by refresh().
+    TangentPolicy m_tangent_policy = TangentPolicy::Consistent; ///< Tangent of `refresh(true)`.
+    size_t m_tangent_interval = 1; ///< See tangent_interval().
+    size_t m_tangent_count = 0; ///< Number of `refresh(true)` since the policy was reset.
+    bool m_tangent = false; ///< `true` if the stored tangent corresponds to the current #m_F.
+    Layout m_layout = Layout::AoS; ///< Layout of the packed tensors.
+    size_t m_packed_stride_item = 6; ///< Distance between items in the packed tensors.
+    size_t m_packed_stride_comp = 1; ///< Distance between components in the packed tensors.
+    Schedule m_schedule = Schedule::Static; ///< Distribution of the items over the threads.
+    std::vector<size_t> m_partition; ///< First item per thread, and #m_size (Pinned/Balanced).
+    Eigensolver m_eigensolver = Eigensolver::Default; ///< Eigensolver used by refresh().
+    size_t m_eigensolver_fallbacks = 0; ///< Number of fallbacks to Eigensolver::Default.
+    array_type::tensor<double, N + 2> m_eigvec; ///< Eigenvectors per item (Eigensolver::Jacobi).
+    bool m_detect_changes = false; ///< If `true` set_F() only recomputes items with a new "F".
+    array_type::tensor<bool, N> m_changed; ///< Items changed by the last set_F() (idem).
+    std::vector<detail::Counters> m_counters; ///< Per thread (if compiled with instrumentation).
+    Output m_outputs = Output::None; ///< Derived outputs computed by refresh().
+    array_type::tensor<double, N> m_sigeq; ///< Equivalent stress per item (Output::Sigeq).
+    array_type::tensor<double, N> m_epseq; ///< Equivalent strain per item (Output::Epseq).
+    array_type::tensor<double, N> m_J; ///< Volume change ratio per item (Output::J).
+    array_type::tensor<double, N> m_energy; ///< Stored energy per item (Output::Energy).
+
+    using GMatTensor::Cartesian3d::Array<N>::m_ndim;
+    using GMatTensor::Cartesian3d::Array<N>::m_stride_tensor2;
+    using GMatTensor::Cartesian3d::Array<N>::m_stride_tensor4;
+    constexpr static size_t m_stride_packed = 6; ///< Storage per packed symmetric tensor.
+    constexpr static size_t m_stride_mandel = 36; ///< Storage per tangent in Mandel notation.
+    using GMatTensor::Cartesian3d::Array<N>::m_size;
+    using GMatTensor::Cartesian3d::Array<N>::m_shape;
+    using GMatTensor::Cartesian3d::Array<N>::m_shape_tensor2;
+    using GMatTensor::Cartesian3d::Array<N>::m_shape_tensor4;
+
+public:
+    using GMatTensor::Cartesian3d::Array<N>::rank;
+    using tangent_type = Tangent; ///< Scalar type in which the tangent is stored.
+
+    /**
+    Storage of the material parameters, fixed by the constructor.
+    \return ParameterStorage.
+    */
+    ParameterStorage parameter_storage() const
+    {
+        return m_parameter_storage;
+    }
+
+    /**
+    Index of the parameter set per item (if ParameterStorage::Phase).
+    \return [shape()].
+    */
+    const array_type::tensor<size_t, N>& phase() const
+    {
+        return m_phase;
+    }
+
+    /**
+    Bulk modulus per item, requires ParameterStorage::Item (see K_expanded() otherwise).
+    \return [shape()].
+    \throw std::runtime_error If the parameters are stored per phase.
+    */
+    const array_type::tensor<double, N>& K() const
+    {
+        GMATELASTOPLASTICFINITESTRAINSIMO_REQUIRE(m_parameter_storage == ParameterStorage::Item);
+        return m_K;
+    }
+
+    /**
+    Bulk modulus per item, for any ParameterStorage
+    (a copy, assembled from the parameter sets if needed).
+    \return [shape()].
+    */
+    array_type::tensor<double, N> K_expanded() const
+    {
+        return this->parameter_per_item(m_K, m_K_table);
+    }
+
+    /**
+    Shear modulus per item, requires ParameterStorage::Item (see G_expanded() otherwise).
+    \return [shape()].
+    \throw std::runtime_error If the parameters are stored per phase.
+    */
+    const array_type::tensor<double, N>& G() const
+    {
+        GMATELASTOPLASTICFINITESTRAINSIMO_REQUIRE(m_parameter_storage == ParameterStorage::Item);
+        return m_G;
+    }
+
+    /**
+    Shear modulus per item, for any ParameterStorage
+    (a copy, assembled from the parameter sets if needed).
+    \return [shape()].
+    */
+    array_type::tensor<double, N> G_expanded() const
+    {
+        return this->parameter_per_item(m_G, m_G_table);
+    }
+
+    /**
+    Set deformation gradient tensors of a subset of items.
+    Internally, this calls refresh_index() to update the stress of these items.
+    \tparam I e.g. `std::vector<size_t>` or `array_type::tensor<size_t, 1>`.
+    \tparam T e.g. `array_type::tensor<double, 3>`
+    \param index Flat indices of the items.
+    \param arg Deformation gradient tensor per item in `index` [index.size(), 3, 3].
+    \param compute_tangent Compute tangent.
+    */
+    template <class I, class T>
+    void set_F_index(const I& index, const T& arg, bool compute_tangent = true)
+    {
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(arg.size() == index.size() * m_stride_tensor2);
+
+        auto& F = this->derived().F();
+
+        for (size_t j = 0; j < index.size(); ++j) {
+            size_t i = index[j];
+            GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(i < m_size);
+            for (size_t c = 0; c < m_stride_tensor2; ++c) {
+                F.flat(i * m_stride_tensor2 + c) = arg.flat(j * m_stride_tensor2 + c);
+            }
+        }
+
+        this->refresh_index(index, compute_tangent);
+    }
+
+    /**
+    Let set_F() only recompute the items whose deformation gradient differs from the one of the
+    last evaluation.
+    This requires that "F" is not modified in-place without calling refresh().
+    If the tangent is requested while it is not up-to-date, all items are recomputed.
+    \param arg Switch.
+    */
+    void set_detect_changes(bool arg)
+    {
+        m_detect_changes = arg;
+
+        if (arg) {
+            m_changed = xt::empty<bool>(m_shape);
+            this->assign_items(m_changed, 1, 1, 1, [](size_t, size_t) { return false; });
+        }
+        else {
+            m_changed = array_type::tensor<bool, N>();
+        }
+    }
+
+    /**
+    See set_detect_changes().
+    \return Switch.
+    */
+    bool detect_changes() const
+    {
+        return m_detect_changes;
+    }
+
+    /**
+    Derived outputs computed by refresh(), see set_outputs().
+    \return Combination of output flags.
+    */
+    Output outputs() const
+    {
+        return m_outputs;
+    }
+
+    /**
+    Counters collected by the last call that updated the stress (e.g. refresh()).
+    Only available if compiled with `GMATELASTOPLASTICFINITESTRAINSIMO_ENABLE_INSTRUMENTATION`
+    (otherwise all counters are zero).
+    \return Counters, summed over all threads (and per thread).
+    */
+    Instrumentation instrumentation() const
+    {
+        return detail::sum_counters(m_counters);
+    }
+
+    /**
+    Equivalent Cauchy stress per item (as Sigeq() of Sig()), requires Output::Sigeq.
+    \return [shape()].
+    */
+    const array_type::tensor<double, N>& sigeq() const
+    {
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(detail::has_output(m_outputs, Output::Sigeq));
+        return m_sigeq;
+    }
+
+    /**
+    Equivalent logarithmic strain per item (as Epseq() of Strain() of F()), requires Output::Epseq.
+    \return [shape()].
+    */
+    const array_type::tensor<double, N>& epseq() const
+    {
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(detail::has_output(m_outputs, Output::Epseq));
+        return m_epseq;
+    }
+
+    /**
+    Volume change ratio `det(F)` per item, requires Output::J.
+    \return [shape()].
+    */
+    const array_type::tensor<double, N>& J() const
+    {
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(detail::has_output(m_outputs, Output::J));
+        return m_J;
+    }
+
+    /**
+    Elastic energy stored per unit reference volume per item, requires Output::Energy.
+    See detail::elastic_energy(), with the elastic logarithmic strain
+    (for LinearHardening after the return map: the energy stored by hardening is not included).
+    \return [shape()].
+    */
+    const array_type::tensor<double, N>& energy() const
+    {
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(detail::has_output(m_outputs, Output::Energy));
+        return m_energy;
+    }
+
+    /**
+    Recompute stress from deformation gradient tensor.
+
+    From C++, this function need **never** be called: the API takes care of this.
+
+    For Python, this function should **only** be called when you modify elements of Eps().
+    For example
+
+        mat.F[e, q, 0, 1] = value
+        ...
+        mat.refresh() # "F" was changed without "mat" knowing
+
+    Instead, if you write an nd-array, the API takes care of the refresh. I.e.
+
+        mat.F = new_F
+        # no further action needed, "mat" was refreshed
+
+    Note though that you can call this function as often as you like, you will only loose time.
+
+    \param compute_tangent
+        Compute tangent (following tangent_policy()).
+        If `false` only the stress (and the plastic state, if any) is updated (for all items):
+        no tangent scratch is initialised and C() is (re)computed only when it is requested.
+
+    Apart from allocating the tangent the first time that it is computed,
+    no memory is allocated: all scratch lives on the stack of each thread.
+    Arrays smaller than `GMATELASTOPLASTICFINITESTRAINSIMO_PARALLEL_MIN_SIZE` are evaluated
+    without starting a parallel region.
+    */
+    void refresh(bool compute_tangent = true)
+    {
+        this->reset_counters();
+
+        if (m_schedule == Schedule::Balanced) {
+            this->derived().balance();
+        }
+
+        this->derived().begin_update(true);
+
+        bool tangent = compute_tangent && this->tangent_due();
+        m_tangent_count += compute_tangent;
+
+        if (!tangent || m_tangent_policy == TangentPolicy::InitialElastic) {
+            this->dispatch_parameters(
+                [&](auto s) { this->template refresh_stress<detail::batch_type>(s); });
+            if (tangent) {
+                this->refresh_initial_tangent();
+            }
+            // with a tangent policy the stored tangent is kept
+            m_tangent = compute_tangent;
+            return;
+        }
+
+        this->allocate_tangent();
+
+        this->dispatch_parameters([&](auto s) {
+            m_eigensolver_fallbacks += this->parallel_ranges([&](size_t begin, size_t end) {
+                size_t nfallback = 0;
+                for (size_t i = begin; i < end; ++i) {
+                    nfallback += this->refresh_tangent(s, i);
+                }
+                return nfallback;
+            });
+        });
+
+        if (m_tangent_policy != TangentPolicy::Consistent) {
+            this->store_tangent_stress();
+        }
+
+        m_tangent = true;
+    }
+
+    /**
+    Recompute stress (and tangent) of a subset of items, see refresh().
+    Afterwards, the tangent is available (for all items) only if it was available before the call,
+    and if `compute_tangent = true`.
+    \tparam T e.g. `std::vector<size_t>` or `array_type::tensor<size_t, 1>`.
+    \param index Flat indices of the items to recompute.
+    \param compute_tangent Compute tangent (of the items in `index`).
+    */
+    template <class T>
+    void refresh_index(const T& index, bool compute_tangent = true)
+    {
+        this->refresh_subset(
+            [&](auto f) { return this->parallel_index(index, f); }, compute_tangent);
+    }
+
+    /**
+    Recompute stress (and tangent) of the items selected by a mask, see refresh_index().
+    \tparam T e.g. `array_type::tensor<bool, N>`.
+    \param mask Recompute item if `true` [shape()].
+    \param compute_tangent Compute tangent (of the selected items).
+    */
+    template <class T>
+    void refresh_mask(const T& mask, bool compute_tangent = true)
+    {
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(xt::has_shape(mask, m_shape));
+        this->refresh_subset(
+            [&](auto f) {
+                return this->parallel_ranges([&](size_t begin, size_t end) {
+                    size_t ret = 0;
+                    for (size_t i = begin; i < end; ++i) {
+                        if (mask.flat(i)) {
+                            ret += f(i);
+                        }
+                    }
+                    return ret;
+                });
+            },
+            compute_tangent);
+    }
+
+    /**
+    Recompute stress and tangent (see refresh()), and contract them with the shape function
+    gradients to the internal force and the stiffness of each element.
+    The tangent follows tangent_policy() as for `refresh(true)` (and is counted as such).
+    With TangentPolicy::Consistent the tangent is contracted without storing it
+    (C() is recomputed if it is requested afterwards).
+    Otherwise the stored tangent is contracted,
+    after it is recomputed and stored if the policy requires it.
+    The last axis of shape() is interpreted as the integration points of an element,
+    the other axes as the elements (i.e. the rank of the array must be at least two),
+    see detail::element_contract() for the contractions.
+    \tparam T e.g. `array_type::tensor<double, N + 2>`
+    \tparam U e.g. `array_type::tensor<double, N>`
+    \tparam R e.g. `array_type::tensor<double, 3>`
+    \param dNdx Shape function gradients per item [shape(), nne, 3].
+    \param dV Integration weight (volume) per item [shape()].
+    \param fe Output: internal force per element [nelem, nne, 3].
+    \param Ke Output: stiffness per element [nelem, nne * 3, nne * 3].
+    */
+    template <class T, class U, class R>
+    void refresh_element(const T& dNdx, const U& dV, R& fe, R& Ke)
+    {
+        GMATELASTOPLASTICFINITESTRAINSIMO_REQUIRE(N >= 2);
+
+        this->reset_counters();
+
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(dNdx.dimension() == N + 2);
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(dNdx.shape(N + 1) == 3);
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(xt::has_shape(dV, m_shape));
+
+        size_t nip = N > 0 ? m_shape[N - 1] : 1;
+        size_t nelem = nip > 0 ? m_size / nip : 0;
+        size_t nne = dNdx.shape(N);
+        size_t n = nne * 3;
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(fe.size() == nelem * n);
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(Ke.size() == nelem * n * n);
+
+        if (m_schedule == Schedule::Balanced) {
+            this->derived().balance();
+        }
+
+        this->derived().begin_update(true);
+
+        std::fill(fe.begin(), fe.end(), 0.0);
+        std::fill(Ke.begin(), Ke.end(), 0.0);
+
+        // the consistent tangent is contracted without storing it,
+        // a tangent policy contracts the stored tangent (that is recomputed when it is due)
+        bool tangent = this->tangent_due();
+        bool consistent = m_tangent_policy == TangentPolicy::Consistent;
+        bool store = tangent && !consistent && m_tangent_policy != TangentPolicy::InitialElastic;
+        ++m_tangent_count;
+
+        // a tangent kept by the tangent policy remains valid (see set_tangent_policy())
+        if (consistent) {
+            m_tangent = false;
+        }
+        else if (tangent) {
+            if (m_tangent_policy == TangentPolicy::InitialElastic) {
+                this->refresh_initial_tangent();
+            }
+            else {
+                this->allocate_tangent();
+            }
+            m_tangent = true;
+        }
+
+        if (nelem == 0) {
+            return;
+        }
+
+        // each element is updated by the thread that owns its first integration point
+        this->dispatch_parameters([&](auto s) {
+            m_eigensolver_fallbacks += this->parallel_ranges([&](size_t begin, size_t end) {
+                size_t nfallback = 0;
+                std::array<double, m_stride_tensor4> C;
+                std::array<double, m_stride_tensor2> Sig;
+                std::array<double, m_stride_tensor2> Sig_tangent;
+                for (size_t e = (begin + nip - 1) / nip; e * nip < end; ++e) {
+                    for (size_t q = 0; q < nip; ++q) {
+                        size_t i = e * nip + q;
+                        if (consistent) {
+                            nfallback += this->derived().refresh_tangent(s, i, false, &C[0]);
+                            this->unpack(m_Sig, i, &Sig[0]);
+                        }
+                        else if (store) {
+                            nfallback += this->refresh_tangent(s, i);
+                            this->unpack(m_Sig, i, &Sig[0]);
+                            this->stored_tangent(i, &Sig[0], &C[0]);
+                        }
+                        else {
+                            nfallback += this->derived().template refresh_items<double>(s, i);
+                            this->unpack(m_Sig, i, &Sig[0]);
+                            this->tangent_stress(i, &Sig_tangent[0]);
+                            this->stored_tangent(i, &Sig_tangent[0], &C[0]);
+                        }
+                        detail::element_contract(
+                            nne,
+                            &dNdx.flat(i * n),
+                            dV.flat(i),
+                            &Sig[0],
+                            &C[0],
+                            &fe.flat(e * n),
+                            &Ke.flat(e * n * n));
+                    }
+                }
+                return nfallback;
+            });
+        });
+
+        if (store) {
+            this->store_tangent_stress();
+        }
+    }
+
+    /**
+    Stress for a candidate deformation gradient, without modifying the object.
+    For LinearHardening the stress follows from the committed state (see increment()),
+    i.e. it is the stress that set_F() would give.
+    This is meant for the trial points of e.g. a line search:
+    F(), Sig(), the plastic state (if any), and the tangent are not changed,
+    and several candidates can be evaluated concurrently.
+    \tparam T e.g. `array_type::tensor<double, N + 2>`
+    \tparam R e.g. `array_type::tensor<double, N + 2>`
+    \param F Candidate deformation gradient tensor per item [shape(), 3, 3].
+    \param Sig Output: Cauchy stress tensor per item [shape(), 3, 3].
+    */
+    template <class T, class R>
+    void evaluate_trial(const T& F, R& Sig) const
+    {
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(xt::has_shape(F, m_shape_tensor2));
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(xt::has_shape(Sig, m_shape_tensor2));
+        this->evaluate_trial_ranges(F.data(), nullptr, Sig.data(), nullptr);
+    }
+
+    /**
+    Stress for a candidate deformation gradient, without modifying the object,
+    and its contribution to the residual in a search direction, see evaluate_trial().
+    The contribution per item is `P : dF` (per unit undeformed volume),
+    with `P` the first Piola-Kirchhoff stress and `dF` the gradient of the search direction,
+    such that the internal force in the search direction is the sum of `dV * work`.
+    \tparam T e.g. `array_type::tensor<double, N + 2>`
+    \tparam R e.g. `array_type::tensor<double, N + 2>`
+    \tparam U e.g. `array_type::tensor<double, N>`
+    \param F Candidate deformation gradient tensor per item [shape(), 3, 3].
+    \param dF Gradient of the search direction per item [shape(), 3, 3].
+    \param Sig Output: Cauchy stress tensor per item [shape(), 3, 3].
+    \param work Output: `P : dF` per item [shape()].
+    */
+    template <class T, class R, class U>
+    void evaluate_trial(const T& F, const T& dF, R& Sig, U& work) const
+    {
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(xt::has_shape(F, m_shape_tensor2));
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(xt::has_shape(dF, m_shape_tensor2));
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(xt::has_shape(Sig, m_shape_tensor2));
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(xt::has_shape(work, m_shape));
+        this->evaluate_trial_ranges(F.data(), dF.data(), Sig.data(), work.data());
+    }
+
+    /**
+    Stress tensor per item.
+    Internally only the independent components are stored (see Sig_packed()),
+    this function returns an expanded copy.
+    \return [shape(), 3, 3].
+    */
+    array_type::tensor<double, N + 2> Sig() const
+    {
+        return this->unpack(this->derived().Sig_packed());
+    }
+
+    /**
+    Tangent tensor per item.
+    If the last refresh() did not compute the tangent, it is computed first
+    (see refresh_tangent_only()).
+    Requires TangentStorage::Full (see C_expanded() otherwise).
+    \return [shape(), 3, 3, 3, 3].
+    */
+    const array_type::tensor<Tangent, N + 4>& C()
+    {
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(m_tangent_storage == TangentStorage::Full);
+
+        if (!m_tangent) {
+            this->refresh_tangent_only();
+        }
+
+        return m_C;
+    }
+
+    /**
+    Tangent tensor per item, for any TangentStorage (a copy).
+    If the last refresh() did not compute the tangent, it is computed first
+    (see refresh_tangent_only()).
+    If the tangent is stored in Mandel notation (see set_tangent_storage()),
+    the full tangent is reconstructed from C_mandel() and Sig()
+    (or the stress with which the tangent was computed, see set_tangent_policy()),
+    without storing it in the class.
+    \return [shape(), 3, 3, 3, 3].
+    */
+    array_type::tensor<Tangent, N + 4> C_expanded()
+    {
+        if (!m_tangent) {
+            this->refresh_tangent_only();
+        }
+
+        if (m_tangent_storage == TangentStorage::Full) {
+            return m_C;
+        }
+
+        array_type::tensor<Tangent, N + 4> ret = xt::empty<Tangent>(m_shape_tensor4);
+
+        this->parallel_ranges([&](size_t begin, size_t end) {
+            std::array<double, m_stride_tensor2> Sig;
+            for (size_t i = begin; i < end; ++i) {
+                this->tangent_stress(i, &Sig[0]);
+                detail::mandel_to_tangent(
+                    &m_C_mandel.flat(i * m_stride_mandel),
+                    &Sig[0],
+                    &ret.flat(i * m_stride_tensor4));
+            }
+            return size_t(0);
+        });
+
+        return ret;
+    }
+
+    /**
+    Tangent tensor per item.
+    Requires that the last refresh() computed the tangent, using TangentStorage::Full.
+    \return [shape(), 3, 3, 3, 3].
+    */
+    const array_type::tensor<Tangent, N + 4>& C() const
+    {
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(m_tangent);
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(m_tangent_storage == TangentStorage::Full);
+        return m_C;
+    }
+
+    /**
+    Symmetric part of the tangent per item, in Mandel notation.
+    The components are ordered as `(0, 0), (1, 1), (2, 2), (1, 2), (0, 2), (0, 1)`,
+    the off-diagonal ones are scaled by \f$ \sqrt{2} \f$.
+    The full tangent follows as
+
+        C_ijkl = Cs_ijkl
+               - 0.5 * (delta_ik Sig_jl + Sig_ik delta_jl + delta_il Sig_jk - Sig_il delta_jk)
+
+    with "Cs" the tensor corresponding to this matrix.
+
+    If the last refresh() did not compute the tangent, it is computed first
+    (see refresh_tangent_only()).
+    If the tangent is stored as full tensor (see set_tangent_storage()),
+    this matrix is computed from C() and Sig()
+    (or the stress with which the tangent was computed, see set_tangent_policy()).
+
+    \return [shape(), 6, 6].
+    */
+    const array_type::tensor<Tangent, N + 2>& C_mandel()
+    {
+        if (!m_tangent) {
+            this->refresh_tangent_only();
+        }
+
+        if (m_tangent_storage == TangentStorage::Mandel) {
+            return m_C_mandel;
+        }
+
+        if (m_C_mandel.size() != m_size * m_stride_mandel) {
+            m_C_mandel = xt::empty<Tangent>(this->shape_mandel());
+        }
+
+        this->parallel_ranges([&](size_t begin, size_t end) {
+            std::array<double, m_stride_tensor2> Sig;
+            for (size_t i = begin; i < end; ++i) {
+                this->tangent_stress(i, &Sig[0]);
+                detail::tangent_to_mandel(
+                    &m_C.flat(i * m_stride_tensor4),
+                    &Sig[0],
+                    &m_C_mandel.flat(i * m_stride_mandel));
+            }
+            return size_t(0);
+        });
+
+        return m_C_mandel;
+    }
+
+    /**
+    Symmetric part of the tangent per item, in Mandel notation.
+    Requires that the last refresh() computed the tangent, using TangentStorage::Mandel.
+    \return [shape(), 6, 6].
+    */
+    const array_type::tensor<Tangent, N + 2>& C_mandel() const
+    {
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(m_tangent);
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(m_tangent_storage == TangentStorage::Mandel);
+        return m_C_mandel;
+    }
+
+    /**
+    Shape of the packed storage of symmetric tensors.
+    \return [shape(), 6] for Layout::AoS, [6, shape()] for Layout::SoA.
+    */
+    std::array<size_t, N + 1> shape_packed() const
+    {
+        std::array<size_t, N + 1> ret;
+
+        if (m_layout == Layout::SoA) {
+            ret[0] = m_stride_packed;
+            std::copy(m_shape.cbegin(), m_shape.cend(), ret.begin() + 1);
+            return ret;
+        }
+
+        std::copy(m_shape.cbegin(), m_shape.cend(), ret.begin());
+        ret[N] = m_stride_packed;
+        return ret;
+    }
+
+    /**
+    Shape of the tangent in Mandel notation.
+    \return [shape(), 6, 6].
+    */
+    std::array<size_t, N + 2> shape_mandel() const
+    {
+        std::array<size_t, N + 2> ret;
+        std::copy(m_shape.cbegin(), m_shape.cend(), ret.begin());
+        ret[N] = 6;
+        ret[N + 1] = 6;
+        return ret;
+    }
+
+    /**
+    Storage of the tangent computed by refresh().
+    \return Storage type.
+    */
+    TangentStorage tangent_storage() const
+    {
+        return m_tangent_storage;
+    }
+
+    /**
+    Set the storage of the tangent computed by refresh().
+    With TangentStorage::Mandel only the [shape(), 6, 6] array C_mandel() is stored,
+    while C() is reconstructed on request.
+    The memory of the tangent in the other storage is released.
+    \param arg Storage type.
+    */
+    void set_tangent_storage(TangentStorage arg)
+    {
+        if (arg == m_tangent_storage) {
+            return;
+        }
+
+        m_tangent_storage = arg;
+        m_tangent = false;
+        m_tangent_count = 0;
+        m_C = array_type::tensor<Tangent, N + 4>();
+        m_C_mandel = array_type::tensor<Tangent, N + 2>();
+    }
+
+    /**
+    Tangent computed by `refresh(true)`.
+    \return Policy.
+    */
+    TangentPolicy tangent_policy() const
+    {
+        return m_tangent_policy;
+    }
+
+    /**
+    Number of calls of `refresh(true)` after which the tangent is recomputed
+    (TangentPolicy::Interval).
+    \return Interval.
+    */
+    size_t tangent_interval() const
+    {
+        return m_tangent_interval;
+    }
+
+    /**
+    Set the tangent computed by `refresh(true)` (and by C() and C_mandel() if needed).
+    With a policy other than TangentPolicy::Consistent, `refresh(true)` updates the stress of all
+    items, but it only recomputes the tangent when the policy requires it;
+    otherwise the stored tangent is kept (and returned by C() and C_mandel()).
+    C_expanded() and C_mandel() convert between the storages (see set_tangent_storage())
+    using the stress with which the kept tangent was computed
+    (zero for TangentPolicy::InitialElastic).
+    The same holds for refresh_index() and refresh_mask(),
+    except that all items are recomputed if the tangent is due.
+    The count restarts at each increment() and rollback() (if applicable),
+    and when the policy or the storage of the tangent is changed.
+    A tangent computed because C() or C_mandel() is requested is not counted.
+    refresh_element() follows the policy as `refresh(true)` does.
+    \param arg Policy.
+    \param interval Recompute every `interval`-th `refresh(true)` (TangentPolicy::Interval).
+    */
+    void set_tangent_policy(TangentPolicy arg, size_t interval = 1)
+    {
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(interval > 0);
+        m_tangent_policy = arg;
+        m_tangent_interval = interval;
+        m_tangent_count = 0;
+        m_tangent = false;
+    }
+
+    /**
+    Eigensolver used by refresh().
+    \return Eigensolver.
+    */
+    Eigensolver eigensolver() const
+    {
+        return m_eigensolver;
+    }
+
+    /**
+    Set the eigensolver used by refresh(), and reset eigensolver_fallbacks().
+    With Eigensolver::Jacobi the eigenvectors of each item are stored, and used as starting point
+    of the next refresh().
+    \param arg Eigensolver.
+    */
+    void set_eigensolver(Eigensolver arg)
+    {
+        m_eigensolver_fallbacks = 0;
+
+        if (arg == m_eigensolver) {
+            return;
+        }
+
+        m_eigensolver = arg;
+
+        if (arg == Eigensolver::Jacobi) {
+            m_eigvec = this->I2_items();
+        }
+        else {
+            m_eigvec = array_type::tensor<double, N + 2>();
+        }
+    }
+
+    /**
+    Number of items for which Eigensolver::Analytic or Eigensolver::Jacobi was not accurate,
+    and Eigensolver::Default was used instead.
+    Accumulated over all calls of refresh() since the last set_eigensolver().
+    \return Count.
+    */
+    size_t eigensolver_fallbacks() const
+    {
+        return m_eigensolver_fallbacks;
+    }
+
+    /**
+    Layout of the packed symmetric tensors.
+    \return Layout.
+    */
+    Layout layout() const
+    {
+        return m_layout;
+    }
+
+    /**
+    Set the layout of the packed symmetric tensors (e.g. Sig_packed()).
+    With Layout::SoA each component is stored contiguously across items,
+    such that batches of consecutive items are loaded with unit stride.
+    The stored state is copied to the new layout.
+    \param arg Layout.
+    */
+    void set_layout(Layout arg)
+    {
+        if (arg == m_layout) {
+            return;
+        }
+
+        size_t stride_item = m_packed_stride_item;
+        size_t stride_comp = m_packed_stride_comp;
+        bool soa = arg == Layout::SoA;
+
+        m_layout = arg;
+        m_packed_stride_item = soa ? 1 : m_stride_packed;
+        m_packed_stride_comp = soa ? m_size : 1;
+        m_Sig = this->relayout(m_Sig, stride_item, stride_comp);
+        this->derived().relayout_state(stride_item, stride_comp);
+    }
+
+    /**
+    Distribution of the items over the threads.
+    \return Schedule.
+    */
+    Schedule schedule() const
+    {
+        return m_schedule;
+    }
+
+protected:
+    /**
+    Derived class, that implements the constitutive response.
+    \return Reference.
+    */
+    D& derived()
+    {
+        return static_cast<D&>(*this);
+    }
+
+    /**
+    Derived class, that implements the constitutive response.
+    \return Reference.
+    */
+    const D& derived() const
+    {
+        return static_cast<const D&>(*this);
+    }
+
+    /**
+    Prepare the state of the derived class before the stress is recomputed
+    (nothing to do here, see e.g. LinearHardening::begin_update()).
+    \param all `true` if the stress of all items is recomputed, `false` for a subset of items.
+    */
+    void begin_update(bool all)
+    {
+        (void)(all);
+    }
+
+    /**
+    Update the distribution of the items over the threads for Schedule::Balanced
+    (nothing to do here: all items have the same cost, see e.g. LinearHardening::balance()).
+    */
+    void balance()
+    {
+    }
+
+    /**
+    Copy the packed symmetric tensors of the derived class to the current layout
+    (nothing to do here, see e.g. LinearHardening::relayout_state()).
+    \param stride_item Distance between items in the previous layout.
+    \param stride_comp Distance between components in the previous layout.
+    */
+    void relayout_state(size_t stride_item, size_t stride_comp)
+    {
+        (void)(stride_item);
+        (void)(stride_comp);
+    }
+
+    /**
+    Initialise the common state (undeformed), after the parameters are set.
+    The state is first touched in parallel, see assign_items().
+    */
+    void init_state()
+    {
+        this->first_touch(m_K);
+        this->first_touch(m_G);
+        this->first_touch(m_phase);
+        m_F = this->I2_items();
+        m_Sig = xt::empty<double>(this->shape_packed());
+    }
+
+    /**
+    Set the distribution of the items over the threads, see e.g. Elastic::set_schedule().
+    With Schedule::Pinned and Schedule::Balanced the items are divided in one contiguous block
+    per thread (see #m_partition).
+    \param arg Schedule.
+    */
+    void partition_items(Schedule arg)
+    {
+        m_schedule = arg;
+        m_partition.clear();
+
+        if (arg == Schedule::Pinned || arg == Schedule::Balanced) {
+            constexpr size_t W = detail::lanes<detail::batch_type>::size;
+            size_t nthreads = detail::max_threads();
+            m_partition.resize(nthreads + 1);
+            for (size_t t = 0; t <= nthreads; ++t) {
+                m_partition[t] = detail::block_begin(m_size, W, t, nthreads);
+            }
+        }
+    }
+
+    /**
+    Copy the common state to newly allocated memory that is first touched according to the
+    current schedule (see first_touch()).
+    */
+    void first_touch_state()
+    {
+        this->first_touch(m_K);
+        this->first_touch(m_G);
+        this->first_touch(m_phase);
+        this->first_touch(m_F);
+        this->first_touch(m_C);
+        this->first_touch(m_C_mandel);
+        this->first_touch(m_Sig_tangent);
+        this->first_touch(m_eigvec);
+        this->first_touch(m_sigeq);
+        this->first_touch(m_epseq);
+        this->first_touch(m_J);
+        this->first_touch(m_energy);
+        this->first_touch(m_changed);
+        m_Sig = this->relayout(m_Sig, m_packed_stride_item, m_packed_stride_comp);
+    }
+
+    /**
+    Material parameter per item.
+    \param item Parameter per item (ParameterStorage::Item).
+    \param table Parameter per phase (ParameterStorage::Phase), or of all items.
+    \return [shape()].
+    */
+    array_type::tensor<double, N> parameter_per_item(
+        const array_type::tensor<double, N>& item,
+        const array_type::tensor<double, 1>& table) const
+    {
+        if (m_parameter_storage == ParameterStorage::Item) {
+            return item;
+        }
+
+        array_type::tensor<double, N> ret = xt::empty<double>(m_shape);
+
+        if (m_parameter_storage == ParameterStorage::Uniform) {
+            ret.fill(table(0));
+            return ret;
+        }
+
+        for (size_t i = 0; i < m_size; ++i) {
+            ret.flat(i) = table(m_phase.flat(i));
+        }
+
+        return ret;
+    }
+
+    /**
+    Call `f(s)` with `s` the tag of the current ParameterStorage (see detail::parameter_storage),
+    such that the kernels are specialised for the storage at compile time.
+    \param f Function.
+    */
+    template <class F>
+    void dispatch_parameters(F f) const
+    {
+        if (m_parameter_storage == ParameterStorage::Uniform) {
+            f(detail::parameter_storage<ParameterStorage::Uniform>());
+        }
+        else if (m_parameter_storage == ParameterStorage::Phase) {
+            f(detail::parameter_storage<ParameterStorage::Phase>());
+        }
+        else {
+            f(detail::parameter_storage<ParameterStorage::Item>());
+        }
+    }
+
+    /**
+    Material parameters of `detail::lanes<T>::size` consecutive items.
+    \param s Storage of the material parameters, see detail::parameter_storage.
+    \param i Index of the first item.
+    \param K Output: bulk modulus.
+    \param G Output: shear modulus.
+    */
+    template <class S, class T>
+    void parameters(S s, size_t i, T& K, T& G) const
+    {
+        const size_t* phase = m_phase.data();
+        K = detail::parameter<T>(s, m_K.data(), phase, m_K_table.data(), i);
+        G = detail::parameter<T>(s, m_G.data(), phase, m_G_table.data(), i);
+    }
+
+    /**
+    Copy the deformation gradient of the items for which it changed,
+    and recompute only these items.
+    \param arg Deformation gradient tensor per item [shape(), 3, 3].
+    \param compute_tangent Compute tangent.
+    */
+    template <class T>
+    void set_F_changed(const T& arg, bool compute_tangent)
+    {
+        auto& F = this->derived().F();
+
+        this->parallel_ranges([&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                bool changed = false;
+                for (size_t c = 0; c < m_stride_tensor2; ++c) {
+                    size_t k = i * m_stride_tensor2 + c;
+                    if (F.flat(k) != arg.flat(k)) {
+                        F.flat(k) = arg.flat(k);
+                        changed = true;
+                    }
+                }
+                m_changed.flat(i) = changed;
+            }
+            return size_t(0);
+        });
+
+        this->refresh_mask(m_changed, compute_tangent);
+    }
+
+    /**
+    Restart the count of `refresh(true)` for a new increment (see set_tangent_policy()).
+    */
+    void reset_tangent_count()
+    {
+        if (m_tangent_policy != TangentPolicy::InitialElastic) {
+            m_tangent_count = 0;
+        }
+    }
+
+    /**
+    Check if `refresh(true)` has to recompute the tangent, following tangent_policy().
+    \return `true` if the tangent is due.
+    */
+    bool tangent_due() const
+    {
+        if (m_tangent_policy == TangentPolicy::Consistent) {
+            return true;
+        }
+        if (m_tangent_policy == TangentPolicy::Interval) {
+            return m_tangent_count % m_tangent_interval == 0;
+        }
+        return m_tangent_count == 0;
+    }
+
+    /**
+    Store the stress with which the tangent was computed, see tangent_stress().
+    */
+    void store_tangent_stress()
+    {
+        if (m_Sig_tangent.size() != m_size * m_stride_packed) {
+            std::array<size_t, N + 1> shape;
+            std::copy(m_shape.cbegin(), m_shape.cend(), shape.begin());
+            shape[N] = m_stride_packed;
+            m_Sig_tangent = xt::empty<double>(shape);
+        }
+
+        this->parallel_ranges([&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                this->gather_packed(m_Sig, i, &m_Sig_tangent.flat(i * m_stride_packed));
+            }
+            return size_t(0);
+        });
+    }
+
+    /**
+    Cauchy stress with which the stored tangent was computed (see set_tangent_policy()),
+    to convert the tangent between the storages (see set_tangent_storage()).
+    \param i Index of the item.
+    \param Sig Output: Cauchy stress [3, 3].
+    */
+    void tangent_stress(size_t i, double* Sig) const
+    {
+        if (m_tangent_policy == TangentPolicy::Consistent) {
+            this->unpack(this->derived().Sig_packed(), i, Sig);
+        }
+        else if (m_tangent_policy == TangentPolicy::InitialElastic) {
+            std::fill(Sig, Sig + m_stride_tensor2, 0.0);
+        }
+        else {
+            detail::unpack(&m_Sig_tangent.flat(i * m_stride_packed), Sig);
+        }
+    }
+
+    /**
+    Compute the tangent that C() and C_mandel() return if the last refresh() did not compute it,
+    without counting it as a `refresh(true)` (see set_tangent_policy()).
+    A tangent kept by the tangent policy is used as is.
+    Otherwise the tangent is computed for the current state
+    (the stress is recomputed along, as it follows from the same decomposition).
+    */
+    void refresh_tangent_only()
+    {
+        if (m_tangent_policy != TangentPolicy::Consistent && m_tangent_count > 0) {
+            m_tangent = true;
+            return;
+        }
+
+        if (m_tangent_policy == TangentPolicy::InitialElastic) {
+            this->refresh_initial_tangent();
+            m_tangent = true;
+            return;
+        }
+
+        this->reset_counters();
+        this->derived().begin_update(true);
+        this->allocate_tangent();
+
+        this->dispatch_parameters([&](auto s) {
+            m_eigensolver_fallbacks += this->parallel_ranges([&](size_t begin, size_t end) {
+                size_t nfallback = 0;
+                for (size_t i = begin; i < end; ++i) {
+                    nfallback += this->refresh_tangent(s, i);
+                }
+                return nfallback;
+            });
+        });
+
+        if (m_tangent_policy != TangentPolicy::Consistent) {
+            this->store_tangent_stress();
+        }
+
+        m_tangent = true;
+    }
+
+    /**
+    Full tangent of one item, from the stored tangent (see set_tangent_storage()).
+    \param i Index of the item.
+    \param Sig Cauchy stress with which the tangent was computed [3, 3], see tangent_stress().
+    \param C Output: tangent [3, 3, 3, 3].
+    */
+    void stored_tangent(size_t i, const double* Sig, double* C) const
+    {
+        if (m_tangent_storage == TangentStorage::Mandel) {
+            std::array<double, m_stride_mandel> M;
+            const Tangent* src = &m_C_mandel.flat(i * m_stride_mandel);
+            std::copy(src, src + m_stride_mandel, M.begin());
+            detail::mandel_to_tangent(&M[0], Sig, C);
+            return;
+        }
+
+        const Tangent* src = &m_C.flat(i * m_stride_tensor4);
+        std::copy(src, src + m_stride_tensor4, C);
+    }
+
+    /**
+    Store the elastic tangent of the undeformed state (TangentPolicy::InitialElastic),
+    using the storage set by set_tangent_storage().
+    */
+    void refresh_initial_tangent()
+    {
+        this->allocate_tangent();
+
+        this->dispatch_parameters([&](auto s) {
+            this->parallel_ranges([&](size_t begin, size_t end) {
+                std::array<double, m_stride_tensor2> vec = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+                std::array<double, m_ndim> Be_val = {1, 1, 1};
+                std::array<double, m_ndim> Sig_val = {0, 0, 0};
+                double K;
+                double G;
+
+                for (size_t i = begin; i < end; ++i) {
+                    this->parameters(s, i, K, G);
+                    double a = 0.5 * K - G / 3.0;
+                    if (m_tangent_storage == TangentStorage::Mandel) {
+                        detail::spectral_tangent_mandel(
+                            &vec[0],
+                            &Be_val[0],
+                            nullptr,
+                            a,
+                            G,
+                            0.0,
+                            1.0,
+                            &m_C_mandel.flat(i * m_stride_mandel));
+                    }
+                    else {
+                        detail::spectral_tangent(
+                            &vec[0],
+                            &Be_val[0],
+                            &Sig_val[0],
+                            nullptr,
+                            a,
+                            G,
+                            0.0,
+                            1.0,
+                            &m_C.flat(i * m_stride_tensor4));
+                    }
+                }
+                return size_t(0);
+            });
+        });
+    }
+
+    /**
+    Reset the counters (if compiled with instrumentation), see instrumentation().
+    */
+    void reset_counters()
+    {
+        if (detail::instrumentation) {
+            size_t n = detail::max_threads();
+            if (!m_partition.empty()) {
+                n = std::max(n, m_partition.size() - 1);
+            }
+            m_counters.assign(n, detail::Counters{});
+        }
+    }
+
+    /**
+    Counters of the current thread.
+    \return Pointer (`nullptr` if compiled without instrumentation).
+    */
+    detail::Counters* counters()
+    {
+        if (!detail::instrumentation || m_counters.empty()) {
+            return nullptr;
+        }
+        return &m_counters[detail::thread_num()];
+    }
+
+    /**
+    Allocate a derived output field (if it is requested and not yet allocated).
+    \param flag Output flag of the field.
+    \param ret Field [shape()].
+    */
+    void allocate_output(Output flag, array_type::tensor<double, N>& ret)
+    {
+        if (detail::has_output(m_outputs, flag) && ret.size() != m_size) {
+            ret = xt::empty<double>(m_shape);
+        }
+    }
+
+    /**
+    Allocate the tangent, in the storage set by set_tangent_storage() (if needed).
+    */
+    void allocate_tangent()
+    {
+        if (m_tangent_storage == TangentStorage::Full) {
+            if (m_C.size() != m_size * m_stride_tensor4) {
+                m_C = xt::empty<Tangent>(m_shape_tensor4);
+            }
+            return;
+        }
+
+        if (m_C_mandel.size() != m_size * m_stride_mandel) {
+            m_C_mandel = xt::empty<Tangent>(this->shape_mandel());
+        }
+    }
+
+    /**
+    Recompute stress (and tangent) of a subset of items.
+    \param loop
+        Function `size_t loop(f)` that calls `size_t f(size_t i)` for each item `i` of the subset,
+        in parallel following schedule() (see parallel_ranges() and parallel_index()),
+        and returns the sum of the return values of `f`.
+    \param compute_tangent Compute tangent.
+    */
+    template <class L>
+    void refresh_subset(L loop, bool compute_tangent)
+    {
+        // the tangent of a policy is that of all items (see set_tangent_policy())
+        bool keep_tangent = false;
+
+        if (compute_tangent && m_tangent_policy != TangentPolicy::Consistent) {
+            if (this->tangent_due()) {
+                this->refresh(true);
+                return;
+            }
+            ++m_tangent_count;
+            compute_tangent = false;
+            keep_tangent = true;
+        }
+
+        this->reset_counters();
+        this->derived().begin_update(false);
+
+        if (compute_tangent) {
+            this->allocate_tangent();
+        }
+
+        this->dispatch_parameters([&](auto s) {
+            m_eigensolver_fallbacks += loop([&](size_t i) -> size_t {
+                GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(i < m_size);
+                if (compute_tangent) {
+                    return this->refresh_tangent(s, i);
+                }
+                return this->derived().template refresh_items<double>(s, i);
+            });
+        });
+        m_tangent = keep_tangent || (m_tangent && compute_tangent);
+    }
+
+    /**
+    Update the stress and the tangent of one item (see the derived class),
+    storing the tangent as set by set_tangent_storage().
+    \param s Storage of the material parameters, see detail::parameter_storage.
+    \param i Index of the item.
+    \return Number of fallbacks of the eigensolver.
+    */
+    template <class S>
+    size_t refresh_tangent(S s, size_t i)
+    {
+        if (m_tangent_storage == TangentStorage::Mandel) {
+            return this->derived().refresh_tangent(
+                s, i, true, &m_C_mandel.flat(i * m_stride_mandel));
+        }
+
+        return this->derived().refresh_tangent(s, i, false, &m_C.flat(i * m_stride_tensor4));
+    }
+
+    /**
+    Update the stress (but not the tangent) of all items, see the derived class.
+    In each range of items (see parallel_ranges()),
+    batches of `detail::lanes<T>::size` consecutive items are evaluated in lockstep,
+    the remaining items one-by-one.
+    \tparam T `double` or SIMD batch, see detail::lanes.
+    \param s Storage of the material parameters, see detail::parameter_storage.
+    */
+    template <class T, class S>
+    void refresh_stress(S s)
+    {
+        constexpr size_t W = detail::lanes<T>::size;
+
+        m_eigensolver_fallbacks += this->parallel_ranges([&](size_t begin, size_t end) {
+            size_t nfallback = 0;
+            size_t i = begin;
+            for (; i + W <= end; i += W) {
+                nfallback += this->derived().template refresh_items<T>(s, i);
+            }
+            for (; i < end; ++i) {
+                nfallback += this->derived().template refresh_items<double>(s, i);
+            }
+            return nfallback;
+        });
+    }
+
+    /**
+    Stress (and `P : dF`) of all items for a candidate deformation gradient,
+    see evaluate_trial().
+    \param F Candidate deformation gradient tensor per item [shape(), 3, 3].
+    \param dF Gradient of the search direction per item [shape(), 3, 3] (or `nullptr`).
+    \param Sig Output: Cauchy stress tensor per item [shape(), 3, 3].
+    \param work Output: `P : dF` per item [shape()] (ignored if `dF` is `nullptr`).
+    */
+    void evaluate_trial_ranges(const double* F, const double* dF, double* Sig, double* work) const
+    {
+        this->dispatch_parameters([&](auto s) {
+            constexpr size_t W = detail::lanes<detail::batch_type>::size;
+
+            this->parallel_ranges([&](size_t begin, size_t end) {
+                size_t i = begin;
+                for (; i + W <= end; i += W) {
+                    this->derived().template evaluate_trial_items<detail::batch_type>(
+                        s, i, F, dF, Sig, work);
+                }
+                for (; i < end; ++i) {
+                    this->derived().template evaluate_trial_items<double>(s, i, F, dF, Sig, work);
+                }
+                return size_t(0);
+            });
+        });
+    }
+
+    /**
+    Cached eigenvectors, used by Eigensolver::Jacobi.
+    \param i Index of the item.
+    \return Pointer to the eigenvectors of item `i` (`nullptr` if not cached).
+    */
+    double* eigvec(size_t i)
+    {
+        if (m_eigensolver != Eigensolver::Jacobi) {
+            return nullptr;
+        }
+        return &m_eigvec.flat(i * m_stride_tensor2);
+    }
+
+    /**
+    Load the packed symmetric tensors of `detail::lanes<T>::size` consecutive items.
+    \param arg Packed tensors [shape_packed()].
+    \param i Index of the first item.
+    \param ret Output: components [6].
+    */
+    template <class T>
+    void gather_packed(const array_type::tensor<double, N + 1>& arg, size_t i, T* ret) const
+    {
+        detail::gather(
+            &arg.flat(i * m_packed_stride_item),
+            m_packed_stride_item,
+            m_packed_stride_comp,
+            m_stride_packed,
+            ret);
+    }
+
+    /**
+    Store the packed symmetric tensors of `detail::lanes<T>::size` consecutive items.
+    \param arg Components [6].
+    \param i Index of the first item.
+    \param ret Output: packed tensors [shape_packed()].
+    */
+    template <class T>
+    void scatter_packed(const T* arg, size_t i, array_type::tensor<double, N + 1>& ret) const
+    {
+        detail::scatter(
+            arg,
+            m_packed_stride_item,
+            m_packed_stride_comp,
+            m_stride_packed,
+            &ret.flat(i * m_packed_stride_item));
+    }
+
+    /**
+    Expand packed symmetric tensors.
+    \param arg Packed tensors [shape_packed()].
+    \return Tensors [shape(), 3, 3].
+    */
+    array_type::tensor<double, N + 2> unpack(const array_type::tensor<double, N + 1>& arg) const
+    {
+        array_type::tensor<double, N + 2> ret = xt::empty<double>(m_shape_tensor2);
 
-\f$ \sqrt{\frac{2}{3} (dev(A))_{ij} (dev(A))_{ji}} \f$
+        this->parallel_ranges([&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                this->unpack(arg, i, &ret.flat(i * m_stride_tensor2));
+            }
+            return size_t(0);
+        });
 
-To write to allocated data use epseq().
+        return ret;
+    }
 
-\param A [..., 3, 3] array.
-\return [...] array.
-*/
-template <class T>
-inline auto Epseq(const T& A) -> typename GMatTensor::allocate<xt::get_rank<T>::value - 2, T>::type
-{
-    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.dimension() >= 2);
-    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.shape(A.dimension() - 1) == 3);
-    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.shape(A.dimension() - 2) == 3);
+    /**
+    Expand the packed symmetric tensor of one item.
+    \param arg Packed tensors [shape_packed()].
+    \param i Index of the item.
+    \param ret Output: tensor [3, 3].
+    */
+    void unpack(const array_type::tensor<double, N + 1>& arg, size_t i, double* ret) const
+    {
+        std::array<double, m_stride_packed> A;
+        detail::gather(
+            &arg.flat(i * m_packed_stride_item),
+            m_packed_stride_item,
+            m_packed_stride_comp,
+            m_stride_packed,
+            &A[0]);
+        detail::unpack(&A[0], ret);
+    }
 
-    using return_type = typename GMatTensor::allocate<xt::get_rank<T>::value - 2, T>::type;
-    return_type ret = GMatTensor::Cartesian3d::Norm_deviatoric(A);
-    ret *= std::sqrt(2.0 / 3.0);
-    return ret;
-}
+    /**
+    Copy packed symmetric tensors to the current layout (see set_layout()).
+    \param arg Packed tensors, in the layout given by the strides.
+    \param stride_item Distance between items in `arg`.
+    \param stride_comp Distance between components in `arg`.
+    \return Packed tensors [shape_packed()].
+    */
+    array_type::tensor<double, N + 1>
+    relayout(const array_type::tensor<double, N + 1>& arg, size_t stride_item, size_t stride_comp)
+        const
+    {
+        array_type::tensor<double, N + 1> ret = xt::empty<double>(this->shape_packed());
 
-/**
-Same as epseq(), but writes to externally allocated output.
+        this->assign_items(
+            ret,
+            m_stride_packed,
+            m_packed_stride_item,
+            m_packed_stride_comp,
+            [&](size_t i, size_t c) { return arg.flat(i * stride_item + c * stride_comp); });
 
-\param A [..., 3, 3] array.
-\param ret output [...] array
-*/
-template <class T, class U>
-inline void epseq(const T& A, U& ret)
-{
-    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.dimension() >= 2);
-    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.shape(A.dimension() - 1) == 3);
-    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.shape(A.dimension() - 2) == 3);
-    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(xt::has_shape(A, ret.shape()));
+        return ret;
+    }
 
-    GMatTensor::Cartesian3d::norm_deviatoric(A, ret);
-    ret *= std::sqrt(2.0 / 3.0);
-}
+    /**
+    Identity tensor per item, see assign_items().
+    \return [shape(), 3, 3].
+    */
+    array_type::tensor<double, N + 2> I2_items() const
+    {
+        array_type::tensor<double, N + 2> ret = xt::empty<double>(m_shape_tensor2);
 
-/**
-Von Mises equivalent stress: norm of strain deviator
+        this->assign_items(ret, m_stride_tensor2, m_stride_tensor2, 1, [](size_t, size_t c) {
+            return c % 4 == 0 ? 1.0 : 0.0;
+        });
 
-\f$ \sqrt{\frac{3}{2} (dev(A))_{ij} (dev(A))_{ji}} \f$
+        return ret;
+    }
 
-To write to allocated data use sigeq().
+    /**
+    Call a function for contiguous ranges of items that together cover all items,
+    in parallel, as set by set_schedule().
+    With Schedule::Static the ranges are batches of `detail::lanes<detail::batch_type>::size`
+    items, distributed by a static `omp for`.
+    With Schedule::Pinned and Schedule::Balanced each thread gets its own block of items
+    (see #m_partition); if fewer threads are started,
+    the remaining blocks are distributed over the started threads.
+    With Schedule::Dynamic the ranges are chunks of about `detail::dynamic_chunk` items,
+    distributed by a dynamic `omp for`.
+    Arrays smaller than `GMATELASTOPLASTICFINITESTRAINSIMO_PARALLEL_MIN_SIZE` are evaluated
+    without starting a parallel region.
+    \param f Function `size_t f(size_t begin, size_t end)`.
+    \return Sum of the return values of `f`.
+    */
+    template <class F>
+    size_t parallel_ranges(F f) const
+    {
+        constexpr size_t W = detail::lanes<detail::batch_type>::size;
+        size_t ret = 0;
+
+        if (!m_partition.empty()) {
+#pragma omp parallel num_threads(static_cast<int>(m_partition.size() - 1)) \
+    if (m_size >= GMATELASTOPLASTICFINITESTRAINSIMO_PARALLEL_MIN_SIZE) reduction(+ : ret)
+            for (size_t t = detail::thread_num(); t + 1 < m_partition.size();
+                 t += detail::num_threads()) {
+                ret += f(m_partition[t], m_partition[t + 1]);
+            }
+            return ret;
+        }
 
-\param A [..., 3, 3] array.
-\return [...] array.
-*/
-template <class T>
-inline auto Sigeq(const T& A) -> typename GMatTensor::allocate<xt::get_rank<T>::value - 2, T>::type
-{
-    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.dimension() >= 2);
-    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.shape(A.dimension() - 1) == 3);
-    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.shape(A.dimension() - 2) == 3);
+        if (m_schedule == Schedule::Dynamic) {
+            size_t chunk = (detail::dynamic_chunk + W - 1) / W * W;
+            size_t nchunk = (m_size + chunk - 1) / chunk;
 
-    using return_type = typename GMatTensor::allocate<xt::get_rank<T>::value - 2, T>::type;
-    return_type ret = GMatTensor::Cartesian3d::Norm_deviatoric(A);
-    ret *= std::sqrt(1.5);
-    return ret;
-}
+#pragma omp parallel for schedule(dynamic) \
+    if (m_size >= GMATELASTOPLASTICFINITESTRAINSIMO_PARALLEL_MIN_SIZE) reduction(+ : ret)
+            for (size_t k = 0; k < nchunk; ++k) {
+                ret += f(k * chunk, std::min(m_size, (k + 1) * chunk));
+            }
+            return ret;
+        }
 
-/**
-Same as Sigeq(), but writes to externally allocated output.
+        size_t nbatch = (m_size + W - 1) / W;
 
-\param A [..., 3, 3] array.
-\param ret output [...] array
-*/
-template <class T, class U>
-inline void sigeq(const T& A, U& ret)
-{
-    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.dimension() >= 2);
-    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.shape(A.dimension() - 1) == 3);
-    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(A.shape(A.dimension() - 2) == 3);
-    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(xt::has_shape(A, ret.shape()));
+#pragma omp parallel for schedule(static) \
+    if (m_size >= GMATELASTOPLASTICFINITESTRAINSIMO_PARALLEL_MIN_SIZE) reduction(+ : ret)
+        for (size_t b = 0; b < nbatch; ++b) {
+            ret += f(b * W, std::min(m_size, (b + 1) * W));
+        }
 
-    GMatTensor::Cartesian3d::norm_deviatoric(A, ret);
-    ret *= std::sqrt(1.5);
-}
+        return ret;
+    }
 
-// Deformation gradient tensor -> strain = 0.5 * ln(B), B = F . F^T
+    /**
+    Call a function for the items in a list, in parallel following schedule():
+    with Schedule::Pinned and Schedule::Balanced each item is handled by the thread that owns it
+    (each thread scans the list for its items), with Schedule::Dynamic threads take chunks of the
+    list, and otherwise the list is divided statically.
+    \param index Flat indices of the items.
+    \param f Function `size_t f(size_t i)`.
+    \return Sum of the return values of `f`.
+    */
+    template <class T, class F>
+    size_t parallel_index(const T& index, F f) const
+    {
+        size_t n = index.size();
+        size_t ret = 0;
+
+        if (!m_partition.empty()) {
+#pragma omp parallel num_threads(static_cast<int>(m_partition.size() - 1)) \
+    if (n >= GMATELASTOPLASTICFINITESTRAINSIMO_PARALLEL_MIN_SIZE) reduction(+ : ret)
+            for (size_t t = detail::thread_num(); t + 1 < m_partition.size();
+                 t += detail::num_threads()) {
+                for (size_t j = 0; j < n; ++j) {
+                    size_t i = index[j];
+                    GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(i < m_size);
+                    if (i >= m_partition[t] && i < m_partition[t + 1]) {
+                        ret += f(i);
+                    }
+                }
+            }
+            return ret;
+        }
 
-/**
-Strain tensor from deformation gradient tensor:
+        if (m_schedule == Schedule::Dynamic) {
+#pragma omp parallel for schedule(dynamic, detail::dynamic_chunk) \
+    if (n >= GMATELASTOPLASTICFINITESTRAINSIMO_PARALLEL_MIN_SIZE) reduction(+ : ret)
+            for (size_t j = 0; j < n; ++j) {
+                ret += f(index[j]);
+            }
+            return ret;
+        }
 
-\f$ \ln(\bm{B}) / 2 \f$
+#pragma omp parallel for schedule(static) \
+    if (n >= GMATELASTOPLASTICFINITESTRAINSIMO_PARALLEL_MIN_SIZE) reduction(+ : ret)
+        for (size_t j = 0; j < n; ++j) {
+            ret += f(index[j]);
+        }
 
-with
+        return ret;
+    }
 
-\f$ \bm{B} = \bm{F} \cdot \bm{F}^T \f$
+    /**
+    Set all items of a field, in parallel using parallel_ranges().
+    Used to initialise and copy the state,
+    such that memory pages are first touched by the thread that updates the corresponding items.
+    \param ret Field: component `c` of item `i` is stored at `i * stride_item + c * stride_comp`.
+    \param ncomp Number of components per item.
+    \param stride_item Distance between items.
+    \param stride_comp Distance between components.
+    \param value Function `value(size_t i, size_t c)` that returns component `c` of item `i`.
+    */
+    template <class T, class F>
+    void assign_items(T& ret, size_t ncomp, size_t stride_item, size_t stride_comp, F value) const
+    {
+        this->parallel_ranges([&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                for (size_t c = 0; c < ncomp; ++c) {
+                    ret.flat(i * stride_item + c * stride_comp) = value(i, c);
+                }
+            }
+            return size_t(0);
+        });
+    }
 
-To write to allocated data use strain().
+    /**
+    Copy a field that stores the components of each item contiguously, see assign_items().
+    \param src Field [shape(), ...].
+    \param dst Output: field of the same shape as `src`.
+    */
+    template <class T>
+    void copy_items(const T& src, T& dst) const
+    {
+        size_t n = m_size > 0 ? src.size() / m_size : 0;
+        this->assign_items(dst, n, n, 1, [&](size_t i, size_t c) { return src.flat(i * n + c); });
+    }
 
-\param A [..., 3, 3] array.
-\return [...] array.
-*/
-template <class T>
-inline auto Strain(const T& A)
-{
-    auto ret = GMatTensor::Cartesian3d::A2_dot_A2T(A);
-    GMatTensor::Cartesian3d::logs(ret, ret);
-    ret *= 0.5;
-    return ret;
-}
+    /**
+    Copy packed symmetric tensors, see assign_items().
+    \param src Packed tensors [shape_packed()].
+    \param dst Output: packed tensors [shape_packed()].
+    */
+    void copy_packed(
+        const array_type::tensor<double, N + 1>& src,
+        array_type::tensor<double, N + 1>& dst) const
+    {
+        size_t si = m_packed_stride_item;
+        size_t sc = m_packed_stride_comp;
+        this->assign_items(dst, m_stride_packed, si, sc, [&](size_t i, size_t c) {
+            return src.flat(i * si + c * sc);
+        });
+    }
 
-/**
-Same as Strain(), but writes to externally allocated output.
+    /**
+    Move a field that stores the components of each item contiguously to newly allocated memory,
+    that is first touched according to the current schedule (see assign_items()).
+    Fields that are not allocated are left untouched.
+    \param arg Field [shape(), ...].
+    */
+    template <class T>
+    void first_touch(T& arg) const
+    {
+        if (arg.size() == 0) {
+            return;
+        }
 
-\param A [..., 3, 3] array.
-\param ret output [...] array
-*/
-template <class T, class U>
-inline void strain(const T& A, U& ret)
-{
-    GMatTensor::Cartesian3d::A2_dot_A2T(A, ret);
-    GMatTensor::Cartesian3d::logs(ret, ret);
-    ret *= 0.5;
-}
+        T ret = T::from_shape(arg.shape());
+        this->copy_items(arg, ret);
+        arg = std::move(ret);
+    }
+};
 
 /**
 Array of material points with a elastic constitutive response.
 \tparam N Rank of the array.
+\tparam Tangent
+    Scalar type in which the tangent is stored (e.g. `float` to halve its memory footprint).
+    All arithmetic, and the storage of the state, is in `double`.
 */
-template <size_t N>
-class Elastic : public GMatTensor::Cartesian3d::Array<N> {
+template <size_t N, class Tangent = double>
+class Elastic : public ArrayBase<Elastic<N, Tangent>, N, Tangent> {
 protected:
-    array_type::tensor<double, N> m_K; ///< Bulk modulus per item.
-    array_type::tensor<double, N> m_G; ///< Shear modulus per item.
-    array_type::tensor<double, N + 2> m_F; ///< Deformation gradient tensor per item.
-    array_type::tensor<double, N + 2> m_Sig; ///< Cauchy stress tensor per item.
-    array_type::tensor<double, N + 4> m_C; ///< Tangent per item.
-
-    using GMatTensor::Cartesian3d::Array<N>::m_ndim;
-    using GMatTensor::Cartesian3d::Array<N>::m_stride_tensor2;
-    using GMatTensor::Cartesian3d::Array<N>::m_stride_tensor4;
-    using GMatTensor::Cartesian3d::Array<N>::m_size;
-    using GMatTensor::Cartesian3d::Array<N>::m_shape;
-    using GMatTensor::Cartesian3d::Array<N>::m_shape_tensor2;
-    using GMatTensor::Cartesian3d::Array<N>::m_shape_tensor4;
+    /**
+    Base class, that implements the functions that do not depend on the constitutive response.
+    */
+    using Base = ArrayBase<Elastic<N, Tangent>, N, Tangent>;
+    friend Base;
+
+    using Base::m_parameter_storage;
+    using Base::m_K;
+    using Base::m_G;
+    using Base::m_phase;
+    using Base::m_K_table;
+    using Base::m_G_table;
+    using Base::m_F;
+    using Base::m_Sig;
+    using Base::m_tangent;
+    using Base::m_eigensolver;
+    using Base::m_detect_changes;
+    using Base::m_outputs;
+    using Base::m_sigeq;
+    using Base::m_epseq;
+    using Base::m_J;
+    using Base::m_energy;
+    using Base::m_ndim;
+    using Base::m_stride_tensor2;
+    using Base::m_stride_packed;
+    using Base::m_shape;
+    using Base::m_shape_tensor2;
 
 public:
-    using GMatTensor::Cartesian3d::Array<N>::rank;
-
     Elastic() = default;
 
     /**
@@ -181,28 +3827,47 @@ public:
 
         m_K = K;
         m_G = G;
-        m_F = this->I2();
-        m_Sig = xt::empty<double>(m_shape_tensor2);
-        m_C = xt::empty<double>(m_shape_tensor4);
-        this->refresh();
+        this->init_state();
     }
 
     /**
-    Bulk modulus per item.
-    \return [shape()].
+    Construct system, with a table of parameter sets ("phases").
+    \param phase Index of the parameter set per item.
+    \param K Bulk modulus per phase.
+    \param G Shear modulus per phase.
     */
-    const array_type::tensor<double, N>& K() const
+    template <class P, class T>
+    Elastic(const P& phase, const T& K, const T& G)
     {
-        return m_K;
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(phase.dimension() == N);
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(K.dimension() == 1);
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(xt::has_shape(K, G.shape()));
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(xt::all(xt::less(phase, K.size())));
+        std::copy(phase.shape().cbegin(), phase.shape().cend(), m_shape.begin());
+        this->init(m_shape);
+
+        m_parameter_storage = ParameterStorage::Phase;
+        m_phase = phase;
+        m_K_table = K;
+        m_G_table = G;
+        this->init_state();
     }
 
     /**
-    Shear modulus per item.
-    \return [shape()].
+    Construct system, with the same parameters for all items.
+    \param shape Shape of the array.
+    \param K Bulk modulus.
+    \param G Shear modulus.
     */
-    const array_type::tensor<double, N>& G() const
+    Elastic(const std::array<size_t, N>& shape, double K, double G)
     {
-        return m_G;
+        std::copy(shape.cbegin(), shape.cend(), m_shape.begin());
+        this->init(m_shape);
+
+        m_parameter_storage = ParameterStorage::Uniform;
+        m_K_table = {K};
+        m_G_table = {G};
+        this->init_state();
     }
 
     /**
@@ -214,9 +3879,7 @@ public:
     template <class T>
     void set_F(const T& arg)
     {
-        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(xt::has_shape(arg, m_shape_tensor2));
-        std::copy(arg.cbegin(), arg.cend(), m_F.begin());
-        this->refresh();
+        this->set_F(arg, true);
     }
 
     /**
@@ -230,222 +3893,357 @@ public:
     void set_F(const T& arg, bool compute_tangent)
     {
         GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(xt::has_shape(arg, m_shape_tensor2));
-        std::copy(arg.cbegin(), arg.cend(), m_F.begin());
+
+        if (m_detect_changes && (m_tangent || !compute_tangent)) {
+            this->set_F_changed(arg, compute_tangent);
+            return;
+        }
+
+        this->assign_items(m_F, m_stride_tensor2, m_stride_tensor2, 1, [&](size_t i, size_t c) {
+            return arg.flat(i * m_stride_tensor2 + c);
+        });
         this->refresh(compute_tangent);
     }
 
     /**
-    Recompute stress from deformation gradient tensor.
-
-    From C++, this function need **never** be called: the API takes care of this.
-
-    For Python, this function should **only** be called when you modify elements of Eps().
-    For example
-
-        mat.F[e, q, 0, 1] = value
-        ...
-        mat.refresh() # "F" was changed without "mat" knowing
-
-    Instead, if you write an nd-array, the API takes care of the refresh. I.e.
-
-        mat.F = new_F
-        # no further action needed, "mat" was refreshed
-
-    Note though that you can call this function as often as you like, you will only loose time.
+    Let refresh() (and all other functions that update the stress) also compute derived output
+    fields, in the same loop as the stress such that no extra pass over the items is needed.
+    The fields are allocated here, and filled by the next refresh().
+    \param arg Combination of output flags, e.g. `Output::Sigeq | Output::Epseq`.
     */
-    void refresh(bool compute_tangent = true)
+    void set_outputs(Output arg)
     {
-        namespace GT = GMatTensor::Cartesian3d::pointer;
-
-#pragma omp parallel
-        {
-            auto II = GMatTensor::Cartesian3d::II();
-            auto I4d = GMatTensor::Cartesian3d::I4d();
-            auto I4s = GMatTensor::Cartesian3d::I4s();
-            auto I4rt = GMatTensor::Cartesian3d::I4rt();
-            auto nI4rt = xt::eval(-1.0 * I4rt);
-
-            double K;
-            double G;
-
-            std::array<double, m_stride_tensor2> Be;
-            std::array<double, m_stride_tensor2> vec;
-            std::array<double, m_ndim> Be_val;
-            std::array<double, m_ndim> Eps_val;
-            std::array<double, m_ndim> Epsd_val;
-            std::array<double, m_ndim> Sig_val;
-
-            std::array<size_t, 4> tensor4 = {m_ndim, m_ndim, m_ndim, m_ndim};
-            array_type::tensor<double, 4> dTau_dlnBe = xt::empty<double>(tensor4);
-            array_type::tensor<double, 4> dlnBe_dBe = xt::empty<double>(tensor4);
-            array_type::tensor<double, 4> dBe_dLT = xt::empty<double>(tensor4);
-            array_type::tensor<double, 4> Kmat = xt::empty<double>(tensor4);
-            array_type::tensor<double, 4> Kgeo = xt::empty<double>(tensor4);
-
-            auto F = xt::adapt(m_F.data(), {m_ndim, m_ndim});
-            auto Sig = xt::adapt(m_Sig.data(), {m_ndim, m_ndim});
-            auto C = xt::adapt(m_C.data(), {m_ndim, m_ndim, m_ndim, m_ndim});
-
-#pragma omp for
-            for (size_t i = 0; i < m_size; ++i) {
-
-                K = m_K.flat(i);
-                G = m_G.flat(i);
-
-                F.reset_buffer(&m_F.flat(i * m_stride_tensor2), m_stride_tensor2);
-                Sig.reset_buffer(&m_Sig.flat(i * m_stride_tensor2), m_stride_tensor2);
-                C.reset_buffer(&m_C.flat(i * m_stride_tensor4), m_stride_tensor4);
-
-                // volume change ratio
-                double J = GT::Det(F.data());
-
-                // Finger tensor
-                GT::A2_dot_A2T(F.data(), &Be[0]);
-
-                // eigenvalue decomposition of the trial "Be"
-                GT::eigs(&Be[0], &vec[0], &Be_val[0]);
-
-                // logarithmic strain "Eps := 0.5 ln(Be)" (in diagonalised form)
-                for (size_t j = 0; j < 3; ++j) {
-                    Eps_val[j] = 0.5 * std::log(Be_val[j]);
-                }
-
-                // decompose strain (in diagonalised form)
-                double epsm = (Eps_val[0] + Eps_val[1] + Eps_val[2]) / 3.0;
-                for (size_t j = 0; j < 3; ++j) {
-                    Epsd_val[j] = Eps_val[j] - epsm;
-                }
-
-                // Cauchy stress (in diagonalised form)
-                for (size_t j = 0; j < 3; ++j) {
-                    Sig_val[j] = (3.0 * K * epsm + 2.0 * G * Epsd_val[j]) / J;
-                }
-
-                // compute Cauchy stress, in original coordinate frame
-                GT::from_eigs(&vec[0], &Sig_val[0], Sig.data());
-
-                if (!compute_tangent) {
-                    return;
-                }
-
-                // 'linearisation' of the constitutive response
-                // Use that "Tau := Ce : Eps = 0.5 * Ce : ln(Be)"
-                xt::noalias(dTau_dlnBe) = 0.5 * K * II + G * I4d;
-                dlnBe_dBe.fill(0.0);
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(!detail::has_output(arg, Output::Dissipation));
+        m_outputs = arg;
+        this->allocate_output(Output::Sigeq, m_sigeq);
+        this->allocate_output(Output::Epseq, m_epseq);
+        this->allocate_output(Output::J, m_J);
+        this->allocate_output(Output::Energy, m_energy);
+    }
 
-                for (size_t m = 0; m < 3; ++m) {
-                    for (size_t n = 0; n < 3; ++n) {
+    /**
+    Strain tensor per item.
+    \return [shape(), 3, 3].
+    */
+    const array_type::tensor<double, N + 2>& F() const
+    {
+        return m_F;
+    }
 
-                        double gc = 2.0 * (Eps_val[n] - Eps_val[m]) / (Be_val[n] - Be_val[m]);
+    /**
+    Strain tensor per item.
+    The user is responsible for calling refresh() after modifying entries.
+    \return [shape(), 3, 3].
+    */
+    array_type::tensor<double, N + 2>& F()
+    {
+        return m_F;
+    }
 
-                        if (Be_val[m] == Be_val[n]) {
-                            gc = 1.0 / Be_val[m];
-                        }
+    /**
+    Stress tensor per item, packed storage of the independent components,
+    in the order `(0, 0), (1, 1), (2, 2), (1, 2), (0, 2), (0, 1)`.
+    \return [shape_packed()], i.e. [shape(), 6] or [6, shape()] depending on layout().
+    */
+    const array_type::tensor<double, N + 1>& Sig_packed() const
+    {
+        return m_Sig;
+    }
 
-                        for (size_t i = 0; i < 3; ++i) {
-                            for (size_t j = 0; j < 3; ++j) {
-                                for (size_t k = 0; k < 3; ++k) {
-                                    for (size_t l = 0; l < 3; ++l) {
-                                        dlnBe_dBe(i, j, k, l) += gc * vec[i * 3 + m] *
-                                                                 vec[j * 3 + n] * vec[k * 3 + m] *
-                                                                 vec[l * 3 + n];
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
+    /**
+    Set the distribution of the items over the threads.
+    With Schedule::Pinned the items are divided in one contiguous block per thread,
+    for the number of threads at the time of this call (`omp_get_max_threads()`),
+    such that each thread always updates the same items (call again to recompute the blocks).
+    All items have the same cost, such that Schedule::Balanced is equivalent to Schedule::Pinned.
+    The state is copied to newly allocated memory that is first touched by the owning threads.
+    \param arg Schedule.
+    */
+    void set_schedule(Schedule arg)
+    {
+        this->partition_items(arg);
+        this->first_touch_state();
+    }
 
-                // linearization of "Be"
-                // Use that "dBe = 2 * (I4s . Be) : LT" (where "LT" refers to "L_\delta^T")
-                // Hence: "dBe_dLT = 2 * (I4s * Be)"
-                GT::A4_dot_B2(I4s.data(), &Be[0], dBe_dLT.data());
-                dBe_dLT *= 2.0;
+protected:
+    /**
+    Initialise the state (undeformed), after the parameters are set.
+    The state is first touched in parallel, see assign_items().
+    */
+    void init_state()
+    {
+        Base::init_state();
+        this->refresh(false);
+    }
 
-                // material tangent stiffness
-                // Kmat = dTau_dlnBe : dlnBe_dBe : dBe_dLT
-                GT::A4_ddot_B4_ddot_C4(
-                    dTau_dlnBe.data(), dlnBe_dBe.data(), dBe_dLT.data(), Kmat.data());
+    /**
+    Update the stress and the tangent of one item.
+    \param s Storage of the material parameters, see detail::parameter_storage.
+    \param i Index of the item.
+    \param mandel Output the symmetric part of the tangent in Mandel notation.
+    \param C Output: tangent [3, 3, 3, 3], or its symmetric part [6, 6] (if `mandel`).
+    \return Number of fallbacks of the eigensolver.
+    */
+    template <class S, class U>
+    size_t refresh_tangent(S s, size_t i, bool mandel, U* C)
+    {
+        double K;
+        double G;
+        double J;
+        std::array<double, m_stride_tensor2> vec;
+        std::array<double, m_ndim> Be_val;
+        std::array<double, m_ndim> Sig_val;
+
+        this->parameters(s, i, K, G);
+
+        // stress, in the eigenbasis of "Be"
+        size_t ret = this->refresh_items(s, i, J, &vec[0], &Be_val[0], &Sig_val[0]);
+
+        // consistent tangent, assembled in the eigenbasis of "Be"
+        // use that "Tau := Ce : Eps = 0.5 * Ce : ln(Be)",
+        // i.e. "dTau_dlnBe = 0.5 * K * II + G * I4d = (0.5 * K - G / 3) * II + G * I4s"
+        detail::Stopwatch watch(this->counters());
+
+        if (mandel) {
+            detail::spectral_tangent_mandel(
+                &vec[0], &Be_val[0], nullptr, 0.5 * K - G / 3.0, G, 0.0, J, C);
+        }
+        else {
+            detail::spectral_tangent(
+                &vec[0], &Be_val[0], &Sig_val[0], nullptr, 0.5 * K - G / 3.0, G, 0.0, J, C);
+        }
 
-                // geometrically non-linear tangent
-                // Kgeo = -I4rt . Tau
-                GT::A4_dot_B2(nI4rt.data(), Sig.data(), Kgeo.data());
+        watch.lap(detail::Phase::Tangent);
+        watch.count_degenerate(&Be_val[0]);
 
-                // combine tangents:
-                xt::noalias(C) = Kgeo + Kmat / J;
-            }
-        }
+        return ret;
     }
 
     /**
-    Strain tensor per item.
-    \return [shape(), 3, 3].
+    Stress (and `P : dF`) of `detail::lanes<T>::size` consecutive items
+    for a candidate deformation gradient, see evaluate_trial().
+    \tparam T `double` or SIMD batch, see detail::lanes.
+    \param s Storage of the material parameters, see detail::parameter_storage.
+    \param i Index of the first item.
+    \param F Candidate deformation gradient tensor per item [shape(), 3, 3].
+    \param dF Gradient of the search direction per item [shape(), 3, 3] (or `nullptr`).
+    \param Sig Output: Cauchy stress tensor per item [shape(), 3, 3].
+    \param work Output: `P : dF` per item [shape()] (ignored if `dF` is `nullptr`).
     */
-    const array_type::tensor<double, N + 2>& F() const
+    template <class T, class S>
+    void evaluate_trial_items(
+        S s,
+        size_t i,
+        const double* F,
+        const double* dF,
+        double* Sig,
+        double* work) const
     {
-        return m_F;
+        T K;
+        T G;
+        std::array<T, m_stride_tensor2> F_trial;
+        std::array<T, m_stride_tensor2> vec;
+        std::array<T, m_stride_packed> Be;
+        std::array<T, m_stride_packed> Sig_trial_packed;
+        std::array<T, m_stride_tensor2> Sig_trial;
+        std::array<T, m_ndim> Be_val;
+        std::array<T, m_ndim> Eps_val;
+        std::array<T, m_ndim> Sig_val;
+
+        this->parameters(s, i, K, G);
+        detail::gather(&F[i * m_stride_tensor2], m_stride_tensor2, 1, 9, &F_trial[0]);
+        T J = detail::det(&F_trial[0]);
+        detail::dot_transpose_packed(&F_trial[0], &Be[0]);
+
+        // (the cached eigenvectors of Eigensolver::Jacobi belong to the current state)
+        Eigensolver solver =
+            m_eigensolver == Eigensolver::Jacobi ? Eigensolver::Analytic : m_eigensolver;
+        detail::eigs_packed(&Be[0], &vec[0], &Be_val[0], solver, nullptr);
+
+        detail::elastic_stress(
+            K, G, J, &vec[0], &Be_val[0], &Eps_val[0], &Sig_val[0], &Sig_trial_packed[0]);
+        detail::unpack(&Sig_trial_packed[0], &Sig_trial[0]);
+        detail::scatter(&Sig_trial[0], m_stride_tensor2, 1, 9, &Sig[i * m_stride_tensor2]);
+
+        if (dF != nullptr) {
+            std::array<T, m_stride_tensor2> dF_trial;
+            detail::gather(&dF[i * m_stride_tensor2], m_stride_tensor2, 1, 9, &dF_trial[0]);
+            T w = detail::piola_contract(J, &Sig_trial[0], &F_trial[0], &dF_trial[0]);
+            detail::lanes<T>::store(w, &work[i]);
+        }
     }
 
     /**
-    Strain tensor per item.
-    The user is responsible for calling refresh() after modifying entries.
-    \return [shape(), 3, 3].
+    Update the stress of `detail::lanes<T>::size` consecutive items.
+    \tparam T `double` or SIMD batch, see detail::lanes.
+    \param s Storage of the material parameters, see detail::parameter_storage.
+    \param i Index of the first item.
+    \return Number of fallbacks of the eigensolver.
     */
-    array_type::tensor<double, N + 2>& F()
+    template <class T, class S>
+    size_t refresh_items(S s, size_t i)
     {
-        return m_F;
+        T J;
+        std::array<T, m_stride_tensor2> vec;
+        std::array<T, m_ndim> Be_val;
+        std::array<T, m_ndim> Sig_val;
+        return this->refresh_items(s, i, J, &vec[0], &Be_val[0], &Sig_val[0]);
     }
 
     /**
-    Stress tensor per item.
-    \return [shape(), 3, 3].
+    Update the stress of `detail::lanes<T>::size` consecutive items,
+    and output the spectral decomposition needed for the tangent.
+    \tparam T `double` or SIMD batch, see detail::lanes.
+    \param s Storage of the material parameters, see detail::parameter_storage.
+    \param i Index of the first item.
+    \param J Output: volume change ratio.
+    \param vec Output: eigenvectors of "Be" [3, 3].
+    \param Be_val Output: eigenvalues of "Be" [3].
+    \param Sig_val Output: eigenvalues of the Cauchy stress [3].
+    \return Number of fallbacks of the eigensolver.
     */
-    const array_type::tensor<double, N + 2>& Sig() const
+    template <class T, class S>
+    size_t refresh_items(S s, size_t i, T& J, T* vec, T* Be_val, T* Sig_val)
     {
-        return m_Sig;
+        T K;
+        T G;
+        std::array<T, m_stride_tensor2> F;
+        std::array<T, m_stride_packed> Be;
+        std::array<T, m_stride_packed> Sig;
+        std::array<T, m_ndim> Eps_val;
+
+        detail::Stopwatch watch(this->counters());
+        this->parameters(s, i, K, G);
+        detail::gather(&m_F.flat(i * m_stride_tensor2), m_stride_tensor2, 1, 9, &F[0]);
+
+        // volume change ratio
+        J = detail::det(&F[0]);
+
+        // Finger tensor
+        detail::dot_transpose_packed(&F[0], &Be[0]);
+        watch.lap(detail::Phase::Kinematics);
+
+        // eigenvalue decomposition of "Be"
+        size_t ret = detail::eigs_packed(&Be[0], vec, Be_val, m_eigensolver, this->eigvec(i));
+        watch.lap(detail::Phase::Eigs);
+
+        // Cauchy stress
+        detail::elastic_stress(K, G, J, vec, Be_val, &Eps_val[0], Sig_val, &Sig[0]);
+
+        this->scatter_packed(&Sig[0], i, m_Sig);
+
+        if (m_outputs != Output::None) {
+            this->store_outputs(i, K, G, J, &Eps_val[0], Sig_val);
+        }
+
+        watch.lap(detail::Phase::Stress);
+        watch.count(T(0.0));
+
+        return ret;
     }
 
     /**
-    Tangent tensor per item.
-    \return [shape(), 3, 3, 3, 3].
+    Store the derived outputs (see set_outputs()) of `detail::lanes<T>::size` consecutive items.
+    \tparam T `double` or SIMD batch, see detail::lanes.
+    \param i Index of the first item.
+    \param K Bulk modulus.
+    \param G Shear modulus.
+    \param J Volume change ratio.
+    \param Eps_val Eigenvalues of the logarithmic strain [3].
+    \param Sig_val Eigenvalues of the Cauchy stress [3].
     */
-    const array_type::tensor<double, N + 4>& C() const
+    template <class T>
+    void store_outputs(
+        size_t i,
+        const T& K,
+        const T& G,
+        const T& J,
+        const T* Eps_val,
+        const T* Sig_val)
     {
-        return m_C;
+        if (detail::has_output(m_outputs, Output::Sigeq)) {
+            T sigeq = std::sqrt(1.5) * detail::norm_deviatoric(Sig_val);
+            detail::lanes<T>::store(sigeq, &m_sigeq.flat(i));
+        }
+        if (detail::has_output(m_outputs, Output::Epseq)) {
+            T epseq = std::sqrt(2.0 / 3.0) * detail::norm_deviatoric(Eps_val);
+            detail::lanes<T>::store(epseq, &m_epseq.flat(i));
+        }
+        if (detail::has_output(m_outputs, Output::J)) {
+            detail::lanes<T>::store(J, &m_J.flat(i));
+        }
+        if (detail::has_output(m_outputs, Output::Energy)) {
+            detail::lanes<T>::store(detail::elastic_energy(K, G, Eps_val), &m_energy.flat(i));
+        }
     }
 };
 
 /**
 Array of material points with a elastic constitutive response.
 \tparam N Rank of the array.
+\tparam Tangent
+    Scalar type in which the tangent is stored (e.g. `float` to halve its memory footprint).
+    All arithmetic, and the storage of the state, is in `double`.
 */
-template <size_t N>
-class LinearHardening : public GMatTensor::Cartesian3d::Array<N> {
+template <size_t N, class Tangent = double>
+class LinearHardening : public ArrayBase<LinearHardening<N, Tangent>, N, Tangent> {
 protected:
-    array_type::tensor<double, N> m_K; ///< Bulk modulus per item.
-    array_type::tensor<double, N> m_G; ///< Shear modulus per item.
-    array_type::tensor<double, N> m_tauy0; ///< Initial yield stress per item.
-    array_type::tensor<double, N> m_H; ///< Hardening modulus per item.
+    array_type::tensor<double, N> m_tauy0; ///< Initial yield stress per item (idem).
+    array_type::tensor<double, N> m_H; ///< Hardening modulus per item (idem).
+    array_type::tensor<double, 1> m_tauy0_table; ///< Initial yield stress per phase (idem).
+    array_type::tensor<double, 1> m_H_table; ///< Hardening modulus per phase (idem).
+    array_type::tensor<double, 1> m_M_table; ///< `3 G + H` per phase (idem).
     array_type::tensor<double, N> m_epsp; ///< Plastic strain per item.
     array_type::tensor<double, N> m_epsp_t; ///< Plastic strain at previous increment per item.
-    array_type::tensor<double, N + 2> m_F; ///< Deformation gradient tensor per item.
+    array_type::tensor<bool, N> m_plastic; ///< `true` if the item yielded in the last update.
+    array_type::tensor<bool, N> m_plastic_t; ///< `true` if the item yielded in the increment.
     array_type::tensor<double, N + 2> m_F_t; ///< Deformation gradient tensor at prev inc per item.
-    array_type::tensor<double, N + 2> m_Be; ///< Elastic Finger tensor per item.
-    array_type::tensor<double, N + 2> m_Be_t; ///< Elastic Finger tensor at prev inc per item.
-    array_type::tensor<double, N + 2> m_Sig; ///< Cauchy stress tensor per item.
-    array_type::tensor<double, N + 4> m_C; ///< Tangent per item.
+    array_type::tensor<double, N + 1> m_Be; ///< Elastic Finger tensor per item (packed).
+    array_type::tensor<double, N + 1> m_Be_t; ///< Elastic Finger tensor at prev inc (packed).
+    array_type::tensor<double, N + 1> m_Cpinv_t; ///< `inv(F_t) . Be_t . inv(F_t)^T` (packed).
+    array_type::tensor<double, N + 1> m_Sig_t; ///< Cauchy stress tensor at prev inc (packed).
+    bool m_F_trial = true; ///< `false` if #m_F is outdated: the current "F" is #m_F_t.
+    bool m_state_trial = true; ///< `false` if #m_Sig, #m_Be, #m_epsp are outdated (use `*_t`).
+    array_type::tensor<double, N> m_dissipation; ///< Dissipation per item (Output::Dissipation).
+    double m_plastic_cost = 2.0; ///< Relative cost of an item that yields (Schedule::Balanced).
+    size_t m_chunk = 0; ///< Number of items per chunk (Schedule::Balanced).
+    std::vector<double> m_chunk_cost; ///< Estimated cost per chunk (Schedule::Balanced).
 
-    using GMatTensor::Cartesian3d::Array<N>::m_ndim;
-    using GMatTensor::Cartesian3d::Array<N>::m_stride_tensor2;
-    using GMatTensor::Cartesian3d::Array<N>::m_stride_tensor4;
-    using GMatTensor::Cartesian3d::Array<N>::m_size;
-    using GMatTensor::Cartesian3d::Array<N>::m_shape;
-    using GMatTensor::Cartesian3d::Array<N>::m_shape_tensor2;
-    using GMatTensor::Cartesian3d::Array<N>::m_shape_tensor4;
+    /**
+    Base class, that implements the functions that do not depend on the constitutive response.
+    */
+    using Base = ArrayBase<LinearHardening<N, Tangent>, N, Tangent>;
+    friend Base;
+
+    using Base::m_parameter_storage;
+    using Base::m_K;
+    using Base::m_G;
+    using Base::m_phase;
+    using Base::m_K_table;
+    using Base::m_G_table;
+    using Base::m_F;
+    using Base::m_Sig;
+    using Base::m_tangent;
+    using Base::m_packed_stride_item;
+    using Base::m_packed_stride_comp;
+    using Base::m_schedule;
+    using Base::m_partition;
+    using Base::m_eigensolver;
+    using Base::m_detect_changes;
+    using Base::m_outputs;
+    using Base::m_sigeq;
+    using Base::m_epseq;
+    using Base::m_J;
+    using Base::m_energy;
+    using Base::m_ndim;
+    using Base::m_stride_tensor2;
+    using Base::m_stride_packed;
+    using Base::m_size;
+    using Base::m_shape;
+    using Base::m_shape_tensor2;
+    using Base::parameters;
 
 public:
-    using GMatTensor::Cartesian3d::Array<N>::rank;
-
     LinearHardening() = default;
 
     /**
@@ -467,53 +4265,101 @@ public:
         m_G = G;
         m_tauy0 = tauy0;
         m_H = H;
-        m_epsp = xt::zeros<double>(m_shape);
-        m_epsp_t = m_epsp;
-        m_F = this->I2();
-        m_F_t = m_F;
-        m_Be = m_F;
-        m_Be_t = m_F;
-        m_Sig = xt::empty<double>(m_shape_tensor2);
-        m_C = xt::empty<double>(m_shape_tensor4);
-        this->refresh();
+        this->init_state();
     }
 
     /**
-    Bulk modulus per item.
-    \return [shape()].
+    Construct system, with a table of parameter sets ("phases").
+    \param phase Index of the parameter set per item.
+    \param K Bulk modulus per phase.
+    \param G Shear modulus per phase.
+    \param tauy0 Initial yield stress per phase.
+    \param H Hardening modulus per phase.
     */
-    const array_type::tensor<double, N>& K() const
+    template <class P, class T>
+    LinearHardening(const P& phase, const T& K, const T& G, const T& tauy0, const T& H)
     {
-        return m_K;
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(phase.dimension() == N);
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(K.dimension() == 1);
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(xt::has_shape(K, G.shape()));
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(xt::has_shape(K, tauy0.shape()));
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(xt::has_shape(K, H.shape()));
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(xt::all(xt::less(phase, K.size())));
+        std::copy(phase.shape().cbegin(), phase.shape().cend(), m_shape.begin());
+        this->init(m_shape);
+
+        m_parameter_storage = ParameterStorage::Phase;
+        m_phase = phase;
+        m_K_table = K;
+        m_G_table = G;
+        m_tauy0_table = tauy0;
+        m_H_table = H;
+        this->init_state();
     }
 
     /**
-    Shear modulus per item.
-    \return [shape()].
+    Construct system, with the same parameters for all items.
+    \param shape Shape of the array.
+    \param K Bulk modulus.
+    \param G Shear modulus.
+    \param tauy0 Initial yield stress.
+    \param H Hardening modulus.
     */
-    const array_type::tensor<double, N>& G() const
+    LinearHardening(const std::array<size_t, N>& shape, double K, double G, double tauy0, double H)
     {
-        return m_G;
+        std::copy(shape.cbegin(), shape.cend(), m_shape.begin());
+        this->init(m_shape);
+
+        m_parameter_storage = ParameterStorage::Uniform;
+        m_K_table = {K};
+        m_G_table = {G};
+        m_tauy0_table = {tauy0};
+        m_H_table = {H};
+        this->init_state();
     }
 
     /**
-    Initial yield stress per item.
+    Initial yield stress per item, requires ParameterStorage::Item (see tauy0_expanded() otherwise).
     \return [shape()].
+    \throw std::runtime_error If the parameters are stored per phase.
     */
     const array_type::tensor<double, N>& tauy0() const
     {
+        GMATELASTOPLASTICFINITESTRAINSIMO_REQUIRE(m_parameter_storage == ParameterStorage::Item);
         return m_tauy0;
     }
 
     /**
-    Hardening modulus per item.
+    Initial yield stress per item, for any ParameterStorage
+    (a copy, assembled from the parameter sets if needed).
+    \return [shape()].
+    */
+    array_type::tensor<double, N> tauy0_expanded() const
+    {
+        return this->parameter_per_item(m_tauy0, m_tauy0_table);
+    }
+
+    /**
+    Hardening modulus per item, requires ParameterStorage::Item (see H_expanded() otherwise).
     \return [shape()].
+    \throw std::runtime_error If the parameters are stored per phase.
     */
     const array_type::tensor<double, N>& H() const
     {
+        GMATELASTOPLASTICFINITESTRAINSIMO_REQUIRE(m_parameter_storage == ParameterStorage::Item);
         return m_H;
     }
 
+    /**
+    Hardening modulus per item, for any ParameterStorage
+    (a copy, assembled from the parameter sets if needed).
+    \return [shape()].
+    */
+    array_type::tensor<double, N> H_expanded() const
+    {
+        return this->parameter_per_item(m_H, m_H_table);
+    }
+
     /**
     Set deformation gradient tensors.
     Internally, this calls refresh() to update stress.
@@ -523,9 +4369,7 @@ public:
     template <class T>
     void set_F(const T& arg)
     {
-        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(xt::has_shape(arg, m_shape_tensor2));
-        std::copy(arg.cbegin(), arg.cend(), m_F.begin());
-        this->refresh();
+        this->set_F(arg, true);
     }
 
     /**
@@ -539,287 +4383,727 @@ public:
     void set_F(const T& arg, bool compute_tangent)
     {
         GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(xt::has_shape(arg, m_shape_tensor2));
-        std::copy(arg.cbegin(), arg.cend(), m_F.begin());
+
+        if (m_detect_changes && ((m_tangent && m_state_trial) || !compute_tangent)) {
+            this->set_F_changed(arg, compute_tangent);
+            return;
+        }
+
+        this->assign_items(m_F, m_stride_tensor2, m_stride_tensor2, 1, [&](size_t i, size_t c) {
+            return arg.flat(i * m_stride_tensor2 + c);
+        });
+        m_F_trial = true;
         this->refresh(compute_tangent);
     }
 
     /**
-    Recompute stress from deformation gradient tensor.
+    Let refresh() (and all other functions that update the stress) also compute derived output
+    fields, in the same loop as the stress such that no extra pass over the items is needed.
+    The fields are allocated here, and filled by the next refresh().
+    Output::Epseq costs a second eigenvalue decomposition per item (of `F . F^T`, as the
+    decomposition of the stress update is that of the elastic part);
+    its fallbacks are included in eigensolver_fallbacks().
+    \param arg Combination of output flags, e.g. `Output::Sigeq | Output::Dissipation`.
+    */
+    void set_outputs(Output arg)
+    {
+        m_outputs = arg;
+        this->allocate_output(Output::Sigeq, m_sigeq);
+        this->allocate_output(Output::Epseq, m_epseq);
+        this->allocate_output(Output::J, m_J);
+        this->allocate_output(Output::Energy, m_energy);
+        this->allocate_output(Output::Dissipation, m_dissipation);
+    }
 
-    From C++, this function need **never** be called: the API takes care of this.
+    /**
+    Plastic dissipation per unit reference volume of the current increment (since the last
+    increment()) per item, requires Output::Dissipation.
+    It is evaluated as `tauy0 * dgamma`, with `dgamma` the plastic strain increment:
+    of the plastic work `(tauy0 + H * epsp) * dgamma`, the part `H * epsp * dgamma` is stored
+    as hardening energy (and is not dissipated).
+    \return [shape()].
+    */
+    const array_type::tensor<double, N>& dissipation() const
+    {
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(
+            detail::has_output(m_outputs, Output::Dissipation));
+        return m_dissipation;
+    }
 
-    For Python, this function should **only** be called when you modify elements of Eps().
-    For example
+    /**
+    Strain tensor per item.
+    \return [shape(), 3, 3].
+    */
+    const array_type::tensor<double, N + 2>& F() const
+    {
+        return m_F_trial ? m_F : m_F_t;
+    }
 
-        mat.F[e, q, 0, 1] = value
-        ...
-        mat.refresh() # "F" was changed without "mat" knowing
+    /**
+    Strain tensor per item.
+    The user is responsible for calling refresh() after modifying entries.
+    Note that increment() and rollback() swap the internal buffers:
+    a reference obtained before calling them may not refer to the current "F" anymore.
+    \return [shape(), 3, 3].
+    */
+    array_type::tensor<double, N + 2>& F()
+    {
+        if (!m_F_trial) {
+            this->copy_items(m_F_t, m_F);
+            m_F_trial = true;
+        }
 
-    Instead, if you write an nd-array, the API takes care of the refresh. I.e.
+        return m_F;
+    }
 
-        mat.F = new_F
-        # no further action needed, "mat" was refreshed
+    /**
+    Stress tensor per item, packed storage of the independent components,
+    in the order `(0, 0), (1, 1), (2, 2), (1, 2), (0, 2), (0, 1)`.
+    \return [shape_packed()], i.e. [shape(), 6] or [6, shape()] depending on layout().
+    */
+    const array_type::tensor<double, N + 1>& Sig_packed() const
+    {
+        return m_state_trial ? m_Sig : m_Sig_t;
+    }
 
-    Note though that you can call this function as often as you like, you will only loose time.
+    /**
+    Set the distribution of the items over the threads.
+    With Schedule::Pinned the items are divided in one contiguous block per thread,
+    for the number of threads at the time of this call (`omp_get_max_threads()`),
+    such that each thread always updates the same items (call again to recompute the blocks).
+    With Schedule::Balanced the blocks are recomputed by each refresh() and refresh_element(),
+    such that they have (nearly) the same estimated cost:
+    the cost of an item is plastic_cost() if it yielded in the previous update, and one otherwise.
+    This balances a concentration of yielding items (e.g. a shear band),
+    at the expense of moving items between threads.
+    With Schedule::Dynamic threads take chunks of items until all are updated.
+    The state is copied to newly allocated memory that is first touched by the owning threads.
+    The resulting distribution is reported by instrumentation().
+    \param arg Schedule.
     */
-    void refresh(bool compute_tangent = true)
+    void set_schedule(Schedule arg)
     {
-        namespace GT = GMatTensor::Cartesian3d::pointer;
+        this->partition_items(arg);
+        m_chunk_cost.clear();
+
+        if (arg == Schedule::Balanced) {
+            constexpr size_t W = detail::lanes<detail::batch_type>::size;
+            size_t nchunk = (m_partition.size() - 1) * detail::balance_chunks;
+            m_chunk = std::max(W, (m_size + nchunk - 1) / nchunk);
+            m_chunk = (m_chunk + W - 1) / W * W;
+            m_chunk_cost.resize((m_size + m_chunk - 1) / m_chunk);
+        }
 
-#pragma omp parallel
-        {
-            auto II = GMatTensor::Cartesian3d::II();
-            auto I4d = GMatTensor::Cartesian3d::I4d();
-            auto I4s = GMatTensor::Cartesian3d::I4s();
-            auto I4rt = GMatTensor::Cartesian3d::I4rt();
-            auto nI4rt = xt::eval(-1.0 * I4rt);
+        this->first_touch_state();
+        this->first_touch(m_tauy0);
+        this->first_touch(m_H);
+        this->first_touch(m_F_t);
+        this->first_touch(m_epsp);
+        this->first_touch(m_epsp_t);
+        this->first_touch(m_plastic);
+        this->first_touch(m_plastic_t);
+        this->first_touch(m_dissipation);
+        this->relayout_state(m_packed_stride_item, m_packed_stride_comp);
+    }
 
-            double K;
-            double G;
-            double tauy0;
-            double H;
-            double epsp_t;
+    /**
+    Estimated cost of updating an item that yields, relative to that of an item that does not.
+    Used by Schedule::Balanced.
+    \return Relative cost.
+    */
+    double plastic_cost() const
+    {
+        return m_plastic_cost;
+    }
 
-            std::array<double, m_stride_tensor2> Finv_t;
-            std::array<double, m_stride_tensor2> Fdelta;
-            std::array<double, m_stride_tensor2> Be_trial;
-            std::array<double, m_stride_tensor2> N2;
-            std::array<double, m_stride_tensor2> vec;
-            std::array<double, m_ndim> Be_trial_val;
-            std::array<double, m_ndim> Epse_val;
-            std::array<double, m_ndim> Epsed_val;
-            std::array<double, m_ndim> Taud_val;
-            std::array<double, m_ndim> Sig_val;
-            std::array<double, m_ndim> N_val;
-            std::array<double, m_ndim> lnBe_val;
-
-            std::array<size_t, 4> tensor4 = {m_ndim, m_ndim, m_ndim, m_ndim};
-            array_type::tensor<double, 4> NN = xt::empty<double>(tensor4);
-            array_type::tensor<double, 4> dTau_dlnBe = xt::empty<double>(tensor4);
-            array_type::tensor<double, 4> dlnBe_dBe = xt::empty<double>(tensor4);
-            array_type::tensor<double, 4> dBe_dLT = xt::empty<double>(tensor4);
-            array_type::tensor<double, 4> Kmat = xt::empty<double>(tensor4);
-            array_type::tensor<double, 4> Kgeo = xt::empty<double>(tensor4);
-
-            auto F = xt::adapt(m_F.data(), {m_ndim, m_ndim});
-            auto F_t = xt::adapt(m_F_t.data(), {m_ndim, m_ndim});
-            auto Be = xt::adapt(m_Be.data(), {m_ndim, m_ndim});
-            auto Be_t = xt::adapt(m_Be_t.data(), {m_ndim, m_ndim});
-            auto Sig = xt::adapt(m_Sig.data(), {m_ndim, m_ndim});
-            auto C = xt::adapt(m_C.data(), {m_ndim, m_ndim, m_ndim, m_ndim});
-
-#pragma omp for
-            for (size_t i = 0; i < m_size; ++i) {
-
-                K = m_K.flat(i);
-                G = m_G.flat(i);
-                tauy0 = m_tauy0.flat(i);
-                H = m_H.flat(i);
-                epsp_t = m_epsp_t.flat(i);
-
-                F.reset_buffer(&m_F.flat(i * m_stride_tensor2), m_stride_tensor2);
-                F_t.reset_buffer(&m_F_t.flat(i * m_stride_tensor2), m_stride_tensor2);
-                Be.reset_buffer(&m_Be.flat(i * m_stride_tensor2), m_stride_tensor2);
-                Be_t.reset_buffer(&m_Be_t.flat(i * m_stride_tensor2), m_stride_tensor2);
-                Sig.reset_buffer(&m_Sig.flat(i * m_stride_tensor2), m_stride_tensor2);
-                C.reset_buffer(&m_C.flat(i * m_stride_tensor4), m_stride_tensor4);
-
-                // volume change ratio
-                double J = GT::Det(F.data());
-
-                // inverse of "F_t"
-                GT::Inv(F_t.data(), &Finv_t[0]);
-
-                // incremental deformation gradient tensor
-                GT::A2_dot_B2(F.data(), &Finv_t[0], &Fdelta[0]);
-
-                // trial elastic Finger tensor (symmetric)
-                // assumes "Fdelta" to result in only elastic deformation: corrected below if needed
-                GT::A2_dot_B2_dot_C2T(&Fdelta[0], Be_t.data(), &Fdelta[0], Be.data());
-
-                // copy trial elastic Finger tensor (not updated by the return map)
-                std::copy(Be.begin(), Be.end(), Be_trial.begin());
-
-                // eigenvalue decomposition of the trial "Be"
-                GT::eigs(&Be_trial[0], &vec[0], &Be_trial_val[0]);
-
-                // logarithmic strain "Eps := 0.5 ln(Be)" (in diagonalised form)
-                for (size_t j = 0; j < 3; ++j) {
-                    Epse_val[j] = 0.5 * std::log(Be_trial_val[j]);
-                }
+    /**
+    Set the estimated cost of updating an item that yields, relative to that of an item that
+    does not (default: 2), see plastic_cost().
+    It can be calibrated using the time per thread reported by instrumentation().
+    \param arg Relative cost.
+    */
+    void set_plastic_cost(double arg)
+    {
+        GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(arg > 0.0);
+        m_plastic_cost = arg;
+    }
 
-                // decompose strain (in diagonalised form)
-                double epsem = (Epse_val[0] + Epse_val[1] + Epse_val[2]) / 3.0;
-                for (size_t j = 0; j < 3; ++j) {
-                    Epsed_val[j] = Epse_val[j] - epsem;
-                }
+    /**
+    Elastic Finger tensor per item.
+    Internally only the independent components are stored (see Be_packed()),
+    this function returns an expanded copy.
+    \return [shape(), 3, 3].
+    */
+    array_type::tensor<double, N + 2> Be() const
+    {
+        return this->unpack(this->Be_packed());
+    }
 
-                // decomposed trial (equivalent) Kirchhoff stress (in diagonalised form)
-                double taum = 3.0 * K * epsem;
-                for (size_t j = 0; j < 3; ++j) {
-                    Taud_val[j] = 2.0 * G * Epsed_val[j];
-                }
-                double taueq = std::sqrt(
-                    1.5 * (std::pow(Taud_val[0], 2.0) + std::pow(Taud_val[1], 2.0) +
-                           std::pow(Taud_val[2], 2.0)));
-
-                // evaluate the yield surface
-                double phi = taueq - (tauy0 + H * epsp_t);
-
-                // (direction of) plastic flow
-                double dgamma = 0.0;
-
-                // return map
-                if (phi > 0) {
-                    // - plastic flow
-                    dgamma = phi / (3.0 * G + H);
-                    // - update trial stress and elastic strain (only the deviatoric part)
-                    for (size_t j = 0; j < 3; ++j) {
-                        N_val[j] = 1.5 * Taud_val[j] / taueq;
-                        Taud_val[j] *= (1.0 - 3.0 * G * dgamma / taueq);
-                        Epsed_val[j] = Taud_val[j] / (2.0 * G);
-                        lnBe_val[j] = std::exp(2.0 * (epsem + Epsed_val[j]));
-                    }
-                    // - update elastic Finger tensor, in original coordinate frame
-                    GT::from_eigs(&vec[0], &lnBe_val[0], Be.data());
-                    // - update equivalent plastic strain
-                    m_epsp.flat(i) = epsp_t + dgamma;
-                }
+    /**
+    Elastic Finger tensor per item, packed storage of the independent components,
+    in the order `(0, 0), (1, 1), (2, 2), (1, 2), (0, 2), (0, 1)`.
+    \return [shape_packed()], i.e. [shape(), 6] or [6, shape()] depending on layout().
+    */
+    const array_type::tensor<double, N + 1>& Be_packed() const
+    {
+        return m_state_trial ? m_Be : m_Be_t;
+    }
 
-                // compute Cauchy stress, in original coordinate frame
-                for (size_t j = 0; j < 3; ++j) {
-                    Sig_val[j] = (taum + Taud_val[j]) / J;
-                }
-                GT::from_eigs(&vec[0], &Sig_val[0], Sig.data());
+    /**
+    Plastic strain per item.
+    \return [shape()].
+    */
+    const array_type::tensor<double, N>& epsp() const
+    {
+        return m_state_trial ? m_epsp : m_epsp_t;
+    }
 
-                if (!compute_tangent) {
-                    return;
-                }
+    /**
+    Active set: items that are yielding in the current state,
+    i.e. for which the last update found a plastic strain increment (`phi > 0`).
+    This is recorded by refresh() at (almost) no cost, and follows increment() and rollback().
+    \return [shape()].
+    */
+    const array_type::tensor<bool, N>& plastic() const
+    {
+        return m_state_trial ? m_plastic : m_plastic_t;
+    }
 
-                // linearisation of the constitutive response
-                if (phi <= 0) {
-                    // - Use that "Tau := Ce : Eps = 0.5 * Ce : ln(Be)"
-                    xt::noalias(dTau_dlnBe) = 0.5 * K * II + G * I4d;
-                }
-                else {
-                    // - Directions of plastic flow
-                    GT::from_eigs(&vec[0], &N_val[0], &N2[0]);
-                    GT::A2_dyadic_B2(&N2[0], &N2[0], NN.data());
-                    // - Temporary constants
-                    double a0;
-                    double a1 = G / (H + 3.0 * G);
-                    if (dgamma != 0.0) {
-                        a0 = dgamma * G / taueq;
-                    }
-                    else {
-                        a0 = 0.0;
-                    }
-                    // - Elasto-plastic tangent
-                    xt::noalias(dTau_dlnBe) = (0.5 * (K - 2.0 / 3.0 * G) + a0 * G) * II +
-                                              (1.0 - 3.0 * a0) * G * I4s + 2.0 * G * (a0 - a1) * NN;
-                }
+    /**
+    Active set of the committed state:
+    items that yielded in the last increment, i.e. plastic() at the time of the last increment()
+    (all `false` before the first).
+    \return [shape()].
+    */
+    const array_type::tensor<bool, N>& plastic_t() const
+    {
+        return m_plastic_t;
+    }
 
-                dlnBe_dBe.fill(0.0);
+    /**
+    Compacted active set: flat indices of the items that are yielding in the current state,
+    see plastic().
+    \return List of indices (in increasing order).
+    */
+    array_type::tensor<size_t, 1> plastic_index() const
+    {
+        const auto& plastic = this->plastic();
+        size_t n = 0;
 
-                for (size_t m = 0; m < 3; ++m) {
-                    for (size_t n = 0; n < 3; ++n) {
+        for (size_t i = 0; i < m_size; ++i) {
+            n += plastic.flat(i);
+        }
 
-                        double gc = (std::log(Be_trial_val[n]) - std::log(Be_trial_val[m])) /
-                                    (Be_trial_val[n] - Be_trial_val[m]);
+        array_type::tensor<size_t, 1> ret = xt::empty<size_t>(std::array<size_t, 1>{n});
+        n = 0;
 
-                        if (Be_trial_val[m] == Be_trial_val[n]) {
-                            gc = 1.0 / Be_trial_val[m];
-                        }
+        for (size_t i = 0; i < m_size; ++i) {
+            if (plastic.flat(i)) {
+                ret(n++) = i;
+            }
+        }
 
-                        for (size_t i = 0; i < 3; ++i) {
-                            for (size_t j = 0; j < 3; ++j) {
-                                for (size_t k = 0; k < 3; ++k) {
-                                    for (size_t l = 0; l < 3; ++l) {
-                                        dlnBe_dBe(i, j, k, l) += gc * vec[i * 3 + m] *
-                                                                 vec[j * 3 + n] * vec[k * 3 + m] *
-                                                                 vec[l * 3 + n];
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
+        return ret;
+    }
+
+    /**
+    Update history variables.
+    The current state becomes the committed state, by swapping buffers (no copies).
+    From the committed state, the inverse of the plastic right Cauchy-Green tensor
+    `inv(Cp_t) = inv(F_t) . Be_t . inv(F_t)^T` is computed once,
+    such that refresh() finds the trial elastic Finger tensor as `F . inv(Cp_t) . F^T`.
+    */
+    void increment()
+    {
+        if (!m_F_trial && !m_state_trial) {
+            return;
+        }
 
-                // linearization of "Be"
-                // Use that "dBe = 2 * (I4s . Be) : LT" (where "LT" refers to "L_\delta^T")
-                // Hence: "dBe_dLT = 2 * (I4s * Be)"
-                GT::A4_dot_B2(I4s.data(), &Be_trial[0], dBe_dLT.data());
-                dBe_dLT *= 2.0;
+        this->reset_tangent_count();
 
-                // material tangent stiffness
-                // Kmat = dTau_dlnBe : dlnBe_dBe : dBe_dLT
-                GT::A4_ddot_B4_ddot_C4(
-                    dTau_dlnBe.data(), dlnBe_dBe.data(), dBe_dLT.data(), Kmat.data());
+        if (m_F_trial) {
+            std::swap(m_F, m_F_t);
+            m_F_trial = false;
+        }
 
-                // geometrically non-linear tangent
-                // Kgeo = -I4rt . Tau
-                GT::A4_dot_B2(nI4rt.data(), Sig.data(), Kgeo.data());
+        if (m_state_trial) {
+            std::swap(m_epsp, m_epsp_t);
+            std::swap(m_plastic, m_plastic_t);
+            std::swap(m_Be, m_Be_t);
+            std::swap(m_Sig, m_Sig_t);
+            m_state_trial = false;
+        }
 
-                // combine tangents:
-                xt::noalias(C) = Kgeo + Kmat / J;
+        this->parallel_ranges([&](size_t begin, size_t end) {
+            std::array<double, m_stride_tensor2> Finv_t;
+            std::array<double, m_stride_packed> Be_t;
+            std::array<double, m_stride_packed> Cpinv_t;
+
+            for (size_t i = begin; i < end; ++i) {
+                detail::inv(&m_F_t.flat(i * m_stride_tensor2), &Finv_t[0]);
+                this->gather_packed(m_Be_t, i, &Be_t[0]);
+                detail::push_forward_packed(&Finv_t[0], &Be_t[0], &Cpinv_t[0]);
+                this->scatter_packed(&Cpinv_t[0], i, m_Cpinv_t);
             }
+            return size_t(0);
+        });
+    }
+
+    /**
+    Restore the state of the last increment() (or of construction):
+    deformation gradient, stress, and history variables.
+    This does not copy any data, the tangent is recomputed when it is requested.
+    */
+    void rollback()
+    {
+        m_F_trial = false;
+        m_state_trial = false;
+        m_tangent = false;
+        this->reset_tangent_count();
+    }
+
+protected:
+    /**
+    Initialise the state (undeformed, no plastic deformation), after the parameters are set.
+    The state is first touched in parallel, see assign_items().
+    */
+    void init_state()
+    {
+        auto zero = [](size_t, size_t) { return 0.0; };
+        auto identity = [](size_t, size_t c) { return c < 3 ? 1.0 : 0.0; };
+
+        Base::init_state();
+        this->first_touch(m_tauy0);
+        this->first_touch(m_H);
+        m_M_table = 3.0 * m_G_table + m_H_table;
+
+        m_epsp = xt::empty<double>(m_shape);
+        m_epsp_t = xt::empty<double>(m_shape);
+        m_plastic = xt::empty<bool>(m_shape);
+        m_plastic_t = xt::empty<bool>(m_shape);
+        this->assign_items(m_epsp, 1, 1, 1, zero);
+        this->assign_items(m_epsp_t, 1, 1, 1, zero);
+        this->assign_items(m_plastic, 1, 1, 1, [](size_t, size_t) { return false; });
+        this->assign_items(m_plastic_t, 1, 1, 1, [](size_t, size_t) { return false; });
+        m_F_t = this->I2_items();
+        m_Be = xt::empty<double>(this->shape_packed());
+        m_Be_t = xt::empty<double>(this->shape_packed());
+        m_Cpinv_t = xt::empty<double>(this->shape_packed());
+        this->assign_items(m_Be, m_stride_packed, m_stride_packed, 1, identity);
+        this->assign_items(m_Be_t, m_stride_packed, m_stride_packed, 1, identity);
+        this->assign_items(m_Cpinv_t, m_stride_packed, m_stride_packed, 1, identity);
+        m_Sig_t = xt::empty<double>(this->shape_packed());
+        this->refresh(false);
+        this->copy_packed(m_Sig, m_Sig_t);
+    }
+
+    /**
+    Material parameters of `detail::lanes<T>::size` consecutive items.
+    \param s Storage of the material parameters, see detail::parameter_storage.
+    \param i Index of the first item.
+    \param K Output: bulk modulus.
+    \param G Output: shear modulus.
+    \param tauy0 Output: initial yield stress.
+    \param H Output: hardening modulus.
+    \param M Output: denominator of the return map, `3 G + H` (tabulated per phase).
+    */
+    template <class S, class T>
+    void parameters(S s, size_t i, T& K, T& G, T& tauy0, T& H, T& M) const
+    {
+        const size_t* phase = m_phase.data();
+        K = detail::parameter<T>(s, m_K.data(), phase, m_K_table.data(), i);
+        G = detail::parameter<T>(s, m_G.data(), phase, m_G_table.data(), i);
+        tauy0 = detail::parameter<T>(s, m_tauy0.data(), phase, m_tauy0_table.data(), i);
+        H = detail::parameter<T>(s, m_H.data(), phase, m_H_table.data(), i);
+        M = detail::plastic_modulus<T>(s, G, H, phase, m_M_table.data(), i);
+    }
+
+    /**
+    Prepare the state before the stress is recomputed.
+    The current deformation gradient becomes the committed one (see increment() and rollback()).
+    If only a subset of items is recomputed, the other items keep their current state:
+    the trial buffers are made to hold it (the tangent of these items is then outdated).
+    \param all `true` if the stress of all items is recomputed, `false` for a subset of items.
+    */
+    void begin_update(bool all)
+    {
+        if (!m_F_trial) {
+            this->copy_items(m_F_t, m_F);
+            m_F_trial = true;
+        }
+
+        if (!all && !m_state_trial) {
+            this->copy_items(m_epsp_t, m_epsp);
+            this->copy_items(m_plastic_t, m_plastic);
+            this->copy_packed(m_Be_t, m_Be);
+            this->copy_packed(m_Sig_t, m_Sig);
+            m_tangent = false;
         }
+
+        m_state_trial = true;
     }
 
     /**
-    Strain tensor per item.
-    \return [shape(), 3, 3].
+    Copy the packed symmetric tensors of the plastic state to the current layout.
+    \param stride_item Distance between items in the previous layout.
+    \param stride_comp Distance between components in the previous layout.
     */
-    const array_type::tensor<double, N + 2>& F() const
+    void relayout_state(size_t stride_item, size_t stride_comp)
     {
-        return m_F;
+        m_Sig_t = this->relayout(m_Sig_t, stride_item, stride_comp);
+        m_Be = this->relayout(m_Be, stride_item, stride_comp);
+        m_Be_t = this->relayout(m_Be_t, stride_item, stride_comp);
+        m_Cpinv_t = this->relayout(m_Cpinv_t, stride_item, stride_comp);
     }
 
     /**
-    Strain tensor per item.
-    The user is responsible for calling refresh() after modifying entries.
-    \return [shape(), 3, 3].
+    Update the stress, the plastic state, and the tangent of one item.
+    \param s Storage of the material parameters, see detail::parameter_storage.
+    \param i Index of the item.
+    \param mandel Output the symmetric part of the tangent in Mandel notation.
+    \param C Output: tangent [3, 3, 3, 3], or its symmetric part [6, 6] (if `mandel`).
+    \return Number of fallbacks of the eigensolver.
     */
-    array_type::tensor<double, N + 2>& F()
+    template <class S, class U>
+    size_t refresh_tangent(S s, size_t i, bool mandel, U* C)
     {
-        return m_F;
+        double K;
+        double G;
+        double tauy0;
+        double H;
+        double M;
+        double J;
+        double dgamma;
+        double taueq;
+        std::array<double, m_stride_tensor2> vec;
+        std::array<double, m_ndim> Be_trial_val;
+        std::array<double, m_ndim> Sig_val;
+        std::array<double, m_ndim> N_val;
+
+        this->parameters(s, i, K, G, tauy0, H, M);
+
+        // stress and plastic state, in the eigenbasis of the trial "Be"
+        size_t ret = this->refresh_items(
+            s, i, J, &vec[0], &Be_trial_val[0], &Sig_val[0], &N_val[0], dgamma, taueq);
+
+        detail::Stopwatch watch(this->counters());
+
+        // linearisation of the constitutive response:
+        // "dTau_dlnBe = a * II + b * I4s + c * N x N"
+        double a;
+        double b;
+        double c;
+        detail::linear_hardening_tangent(K, G, M, dgamma, taueq, a, b, c);
+
+        // consistent tangent, assembled in the eigenbasis of the trial "Be"
+        if (mandel) {
+            detail::spectral_tangent_mandel(&vec[0], &Be_trial_val[0], &N_val[0], a, b, c, J, C);
+        }
+        else {
+            detail::spectral_tangent(
+                &vec[0], &Be_trial_val[0], &Sig_val[0], &N_val[0], a, b, c, J, C);
+        }
+
+        watch.lap(detail::Phase::Tangent);
+        watch.count_degenerate(&Be_trial_val[0]);
+
+        return ret;
     }
 
     /**
-    Stress tensor per item.
-    \return [shape(), 3, 3].
+    Stress (and `P : dF`) of `detail::lanes<T>::size` consecutive items
+    for a candidate deformation gradient, see evaluate_trial().
+    \tparam T `double` or SIMD batch, see detail::lanes.
+    \param s Storage of the material parameters, see detail::parameter_storage.
+    \param i Index of the first item.
+    \param F Candidate deformation gradient tensor per item [shape(), 3, 3].
+    \param dF Gradient of the search direction per item [shape(), 3, 3] (or `nullptr`).
+    \param Sig Output: Cauchy stress tensor per item [shape(), 3, 3].
+    \param work Output: `P : dF` per item [shape()] (ignored if `dF` is `nullptr`).
     */
-    const array_type::tensor<double, N + 2>& Sig() const
+    template <class T, class S>
+    void evaluate_trial_items(
+        S s,
+        size_t i,
+        const double* F,
+        const double* dF,
+        double* Sig,
+        double* work) const
     {
-        return m_Sig;
+        T K;
+        T G;
+        T tauy0;
+        T H;
+        T M;
+        T dgamma;
+        T taueq;
+        std::array<T, m_stride_tensor2> F_trial;
+        std::array<T, m_stride_packed> Cpinv_t;
+        std::array<T, m_stride_packed> Be_trial;
+        std::array<T, m_stride_tensor2> vec;
+        std::array<T, m_stride_packed> Be;
+        std::array<T, m_stride_packed> Sig_trial_packed;
+        std::array<T, m_stride_tensor2> Sig_trial;
+        std::array<T, m_ndim> Be_trial_val;
+        std::array<T, m_ndim> Epse_val;
+        std::array<T, m_ndim> Sig_val;
+        std::array<T, m_ndim> N_val;
+
+        this->parameters(s, i, K, G, tauy0, H, M);
+        T epsp_t = detail::lanes<T>::load(&m_epsp_t.flat(i));
+        detail::gather(&F[i * m_stride_tensor2], m_stride_tensor2, 1, 9, &F_trial[0]);
+        this->gather_packed(m_Cpinv_t, i, &Cpinv_t[0]);
+        T J = detail::det(&F_trial[0]);
+        detail::push_forward_packed(&F_trial[0], &Cpinv_t[0], &Be_trial[0]);
+
+        // (the cached eigenvectors of Eigensolver::Jacobi belong to the current state)
+        Eigensolver solver =
+            m_eigensolver == Eigensolver::Jacobi ? Eigensolver::Analytic : m_eigensolver;
+        detail::eigs_packed(&Be_trial[0], &vec[0], &Be_trial_val[0], solver, nullptr);
+
+        detail::linear_hardening_stress(
+            K,
+            G,
+            tauy0,
+            H,
+            M,
+            epsp_t,
+            J,
+            &Be_trial[0],
+            &vec[0],
+            &Be_trial_val[0],
+            &Be[0],
+            &Sig_trial_packed[0],
+            &Epse_val[0],
+            &Sig_val[0],
+            &N_val[0],
+            dgamma,
+            taueq);
+        detail::unpack(&Sig_trial_packed[0], &Sig_trial[0]);
+        detail::scatter(&Sig_trial[0], m_stride_tensor2, 1, 9, &Sig[i * m_stride_tensor2]);
+
+        if (dF != nullptr) {
+            std::array<T, m_stride_tensor2> dF_trial;
+            detail::gather(&dF[i * m_stride_tensor2], m_stride_tensor2, 1, 9, &dF_trial[0]);
+            T w = detail::piola_contract(J, &Sig_trial[0], &F_trial[0], &dF_trial[0]);
+            detail::lanes<T>::store(w, &work[i]);
+        }
     }
 
     /**
-    Tangent tensor per item.
-    \return [shape(), 3, 3, 3, 3].
+    Update the stress and the plastic state of `detail::lanes<T>::size` consecutive items.
+    \tparam T `double` or SIMD batch, see detail::lanes.
+    \param s Storage of the material parameters, see detail::parameter_storage.
+    \param i Index of the first item.
+    \return Number of fallbacks of the eigensolver.
     */
-    const array_type::tensor<double, N + 4>& C() const
+    template <class T, class S>
+    size_t refresh_items(S s, size_t i)
     {
-        return m_C;
+        T J;
+        T dgamma;
+        T taueq;
+        std::array<T, m_stride_tensor2> vec;
+        std::array<T, m_ndim> Be_trial_val;
+        std::array<T, m_ndim> Sig_val;
+        std::array<T, m_ndim> N_val;
+        return this->refresh_items(
+            s, i, J, &vec[0], &Be_trial_val[0], &Sig_val[0], &N_val[0], dgamma, taueq);
     }
 
     /**
-    Plastic strain per item.
-    \return [shape()].
+    Update the stress and the plastic state of `detail::lanes<T>::size` consecutive items,
+    and output the spectral decomposition and the return map needed for the tangent.
+    \tparam T `double` or SIMD batch, see detail::lanes.
+    \param s Storage of the material parameters, see detail::parameter_storage.
+    \param i Index of the first item.
+    \param J Output: volume change ratio.
+    \param vec Output: eigenvectors of the trial "Be" [3, 3].
+    \param Be_trial_val Output: eigenvalues of the trial "Be" [3].
+    \param Sig_val Output: eigenvalues of the Cauchy stress [3].
+    \param N_val Output: eigenvalues of the direction of plastic flow [3].
+    \param dgamma Output: plastic strain increment.
+    \param taueq Output: trial equivalent Kirchhoff stress.
+    \return Number of fallbacks of the eigensolver.
     */
-    const array_type::tensor<double, N>& epsp() const
+    template <class T, class S>
+    size_t refresh_items(
+        S s,
+        size_t i,
+        T& J,
+        T* vec,
+        T* Be_trial_val,
+        T* Sig_val,
+        T* N_val,
+        T& dgamma,
+        T& taueq)
     {
-        return m_epsp;
+        T K;
+        T G;
+        T tauy0;
+        T H;
+        T M;
+        T epsp_t;
+        std::array<T, m_stride_tensor2> F;
+        std::array<T, m_stride_packed> Cpinv_t;
+        std::array<T, m_stride_packed> Be_trial;
+        std::array<T, m_stride_packed> Be;
+        std::array<T, m_stride_packed> Sig;
+        std::array<T, m_ndim> Epse_val;
+
+        detail::Stopwatch watch(this->counters());
+        this->parameters(s, i, K, G, tauy0, H, M);
+        epsp_t = detail::lanes<T>::load(&m_epsp_t.flat(i));
+        detail::gather(&m_F.flat(i * m_stride_tensor2), m_stride_tensor2, 1, 9, &F[0]);
+        this->gather_packed(m_Cpinv_t, i, &Cpinv_t[0]);
+
+        // volume change ratio
+        J = detail::det(&F[0]);
+
+        // trial elastic Finger tensor: "Fdelta . Be_t . Fdelta^T" with "Fdelta = F . inv(F_t)"
+        // assumes "Fdelta" to result in only elastic deformation: corrected below if needed
+        detail::push_forward_packed(&F[0], &Cpinv_t[0], &Be_trial[0]);
+        watch.lap(detail::Phase::Kinematics);
+
+        // eigenvalue decomposition of the trial "Be"
+        size_t ret =
+            detail::eigs_packed(&Be_trial[0], vec, Be_trial_val, m_eigensolver, this->eigvec(i));
+        watch.lap(detail::Phase::Eigs);
+
+        // return map and Cauchy stress
+        detail::linear_hardening_stress(
+            K,
+            G,
+            tauy0,
+            H,
+            M,
+            epsp_t,
+            J,
+            &Be_trial[0],
+            vec,
+            Be_trial_val,
+            &Be[0],
+            &Sig[0],
+            &Epse_val[0],
+            Sig_val,
+            N_val,
+            dgamma,
+            taueq);
+
+        // update equivalent plastic strain and the active set
+        // (also for elastic items: an earlier call may have been plastic)
+        detail::lanes<T>::store(epsp_t + dgamma, &m_epsp.flat(i));
+        detail::store_positive(dgamma, &m_plastic.flat(i));
+        this->scatter_packed(&Be[0], i, m_Be);
+        this->scatter_packed(&Sig[0], i, m_Sig);
+
+        if (m_outputs != Output::None) {
+            ret += this->store_outputs(i, K, G, J, tauy0 * dgamma, &F[0], &Epse_val[0], Sig_val);
+        }
+
+        watch.lap(detail::Phase::Stress);
+        watch.count(dgamma);
+
+        return ret;
     }
 
     /**
-    Update history variables.
+    Store the derived outputs (see set_outputs()) of `detail::lanes<T>::size` consecutive items.
+    \tparam T `double` or SIMD batch, see detail::lanes.
+    \param i Index of the first item.
+    \param K Bulk modulus.
+    \param G Shear modulus.
+    \param J Volume change ratio.
+    \param dissipation Plastic dissipation of the current increment.
+    \param F Deformation gradient tensor [3, 3].
+    \param Epse_val Eigenvalues of the elastic logarithmic strain [3].
+    \param Sig_val Eigenvalues of the Cauchy stress [3].
+    \return Number of fallbacks of the eigensolver (Output::Epseq).
     */
-    void increment()
+    template <class T>
+    size_t store_outputs(
+        size_t i,
+        const T& K,
+        const T& G,
+        const T& J,
+        const T& dissipation,
+        const T* F,
+        const T* Epse_val,
+        const T* Sig_val)
+    {
+        using std::log;
+        size_t ret = 0;
+
+        if (detail::has_output(m_outputs, Output::Sigeq)) {
+            T sigeq = std::sqrt(1.5) * detail::norm_deviatoric(Sig_val);
+            detail::lanes<T>::store(sigeq, &m_sigeq.flat(i));
+        }
+        if (detail::has_output(m_outputs, Output::Epseq)) {
+            // total logarithmic strain "Eps := 0.5 ln(F . F^T)": needs its own eigenvalues
+            Eigensolver solver =
+                m_eigensolver == Eigensolver::Jacobi ? Eigensolver::Analytic : m_eigensolver;
+            std::array<T, m_stride_packed> B;
+            std::array<T, m_stride_tensor2> vec;
+            std::array<T, m_ndim> Eps_val;
+            detail::dot_transpose_packed(F, &B[0]);
+            ret += detail::eigs_packed(&B[0], &vec[0], &Eps_val[0], solver, nullptr);
+            for (size_t j = 0; j < 3; ++j) {
+                Eps_val[j] = 0.5 * log(Eps_val[j]);
+            }
+            T epseq = std::sqrt(2.0 / 3.0) * detail::norm_deviatoric(&Eps_val[0]);
+            detail::lanes<T>::store(epseq, &m_epseq.flat(i));
+        }
+        if (detail::has_output(m_outputs, Output::J)) {
+            detail::lanes<T>::store(J, &m_J.flat(i));
+        }
+        if (detail::has_output(m_outputs, Output::Energy)) {
+            detail::lanes<T>::store(detail::elastic_energy(K, G, Epse_val), &m_energy.flat(i));
+        }
+        if (detail::has_output(m_outputs, Output::Dissipation)) {
+            detail::lanes<T>::store(dissipation, &m_dissipation.flat(i));
+        }
+
+        return ret;
+    }
+
+    /**
+    Divide the items in one contiguous block per thread, such that the blocks have (nearly) the
+    same estimated cost (Schedule::Balanced).
+    An item that yielded in the previous update (see plastic()) costs plastic_cost();
+    other items cost one.
+    The cost is summed per chunk of #m_chunk items, such that the blocks consist of whole chunks.
+    */
+    void balance()
     {
-        std::copy(m_epsp.cbegin(), m_epsp.cend(), m_epsp_t.begin());
-        std::copy(m_F.cbegin(), m_F.cend(), m_F_t.begin());
-        std::copy(m_Be.cbegin(), m_Be.cend(), m_Be_t.begin());
+        size_t nthreads = m_partition.size() - 1;
+        size_t nchunk = m_chunk_cost.size();
+        const auto& plastic = this->plastic();
+
+#pragma omp parallel for if (m_size >= GMATELASTOPLASTICFINITESTRAINSIMO_PARALLEL_MIN_SIZE)
+        for (size_t k = 0; k < nchunk; ++k) {
+            double cost = 0.0;
+            for (size_t i = k * m_chunk; i < std::min(m_size, (k + 1) * m_chunk); ++i) {
+                cost += plastic.flat(i) ? m_plastic_cost : 1.0;
+            }
+            m_chunk_cost[k] = cost;
+        }
+
+        double total = 0.0;
+        for (size_t k = 0; k < nchunk; ++k) {
+            total += m_chunk_cost[k];
+        }
+
+        double sum = 0.0;
+        size_t k = 0;
+
+        for (size_t t = 1; t < nthreads; ++t) {
+            double target = total * static_cast<double>(t) / static_cast<double>(nthreads);
+            while (k < nchunk && sum + 0.5 * m_chunk_cost[k] < target) {
+                sum += m_chunk_cost[k];
+                ++k;
+            }
+            m_partition[t] = std::min(m_size, k * m_chunk);
+        }
     }
 };
 
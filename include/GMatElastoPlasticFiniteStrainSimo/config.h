@@ -33,6 +33,47 @@ The advantage is that:
 #define GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(expr)
 #endif
 
+/**
+Checks of the input that are always performed (also if assertions are not enabled)
+are implemented as:
+
+    GMATELASTOPLASTICFINITESTRAINSIMO_REQUIRE(...)
+
+\throw std::runtime_error
+*/
+#define GMATELASTOPLASTICFINITESTRAINSIMO_REQUIRE(expr) \
+    GMATTENSOR_ASSERT_IMPL(expr, __FILE__, __LINE__)
+
+/**
+Collect counters during the functions that update the stress (e.g. `refresh()`):
+the time per phase, the number of yielding items, ..., see e.g. `Elastic::instrumentation()`.
+They can be enabled by:
+
+    #define GMATELASTOPLASTICFINITESTRAINSIMO_ENABLE_INSTRUMENTATION
+
+(before including GMatElastoPlasticFiniteStrainSimo).
+Otherwise no counters are collected: the instrumentation is compiled out.
+*/
+#ifdef GMATELASTOPLASTICFINITESTRAINSIMO_ENABLE_INSTRUMENTATION
+#define GMATELASTOPLASTICFINITESTRAINSIMO_INSTRUMENTATION true
+#else
+#define GMATELASTOPLASTICFINITESTRAINSIMO_INSTRUMENTATION false
+#endif
+
+/**
+Minimal number of items for which the loops over items are run in parallel
+(if compiled with OpenMP).
+For smaller arrays the overhead of starting a parallel region outweighs the gain.
+It can be changed by:
+
+    #define GMATELASTOPLASTICFINITESTRAINSIMO_PARALLEL_MIN_SIZE 64
+
+(before including GMatElastoPlasticFiniteStrainSimo).
+*/
+#ifndef GMATELASTOPLASTICFINITESTRAINSIMO_PARALLEL_MIN_SIZE
+#define GMATELASTOPLASTICFINITESTRAINSIMO_PARALLEL_MIN_SIZE 64
+#endif
+
 /**
 Linear elastic material model.
 */
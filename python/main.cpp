@@ -30,13 +30,92 @@ auto Elastic(T& cls)
         py::arg("K"),
         py::arg("G"));
 
+    cls.def(
+        py::init<const std::array<size_t, S::rank>&, double, double>(),
+        "Homogeneous system.",
+        py::arg("shape"),
+        py::arg("K"),
+        py::arg("G"));
+
+    cls.def(
+        py::init<
+            const xt::pytensor<size_t, S::rank>&,
+            const xt::pytensor<double, 1>&,
+            const xt::pytensor<double, 1>&>(),
+        "System of phases.",
+        py::arg("phase"),
+        py::arg("K"),
+        py::arg("G"));
+
     cls.def_property_readonly("shape", &S::shape, "Shape of array.");
     cls.def_property_readonly("shape_tensor2", &S::shape_tensor2, "Array of rank 2 tensors.");
     cls.def_property_readonly("shape_tensor4", &S::shape_tensor4, "Array of rank 4 tensors.");
-    cls.def_property_readonly("K", &S::K, "Bulk modulus.");
-    cls.def_property_readonly("G", &S::G, "Shear modulus.");
+    cls.def_property_readonly(
+        "parameter_storage", &S::parameter_storage, "Storage of the material parameters.");
+    cls.def_property_readonly("phase", &S::phase, "Index of the parameter set per item.");
+    cls.def_property_readonly("K", &S::K_expanded, "Bulk modulus.");
+    cls.def_property_readonly("G", &S::G_expanded, "Shear modulus.");
     cls.def_property_readonly("Sig", &S::Sig, "Cauchy stress tensor.");
-    cls.def_property_readonly("C", &S::C, "Tangent tensor.");
+    cls.def_property_readonly("Sig_packed", &S::Sig_packed, "Cauchy stress tensor (packed).");
+    cls.def_property_readonly(
+        "C",
+        [](py::object obj) -> py::object {
+            S& self = obj.cast<S&>();
+            // with the Mandel storage the full tangent is reconstructed in a new array
+            if (self.tangent_storage() == decltype(self.tangent_storage())::Full) {
+                return py::cast(self.C(), py::return_value_policy::reference_internal, obj);
+            }
+            return py::cast(self.C_expanded());
+        },
+        "Tangent tensor (computed if the last refresh did not).");
+
+    cls.def_property_readonly(
+        "C_mandel",
+        static_cast<const xt::pytensor<typename S::tangent_type, S::rank + 2>& (S::*)()>(
+            &S::C_mandel),
+        "Symmetric part of the tangent in Mandel notation (computed if the last refresh did not).");
+
+    cls.def_property_readonly("shape_packed", &S::shape_packed, "Array of packed tensors.");
+    cls.def_property_readonly("shape_mandel", &S::shape_mandel, "Array of Mandel matrices.");
+
+    cls.def_property(
+        "tangent_storage",
+        &S::tangent_storage,
+        &S::set_tangent_storage,
+        "Storage of the tangent computed by refresh.");
+
+    cls.def_property_readonly(
+        "tangent_policy", &S::tangent_policy, "Tangent computed by refresh (modified Newton).");
+
+    cls.def_property_readonly(
+        "tangent_interval", &S::tangent_interval, "Interval of TangentPolicy.Interval.");
+
+    cls.def(
+        "set_tangent_policy",
+        &S::set_tangent_policy,
+        "Set the tangent computed by refresh.",
+        py::arg("policy"),
+        py::arg("interval") = 1);
+
+    cls.def_property(
+        "layout", &S::layout, &S::set_layout, "Memory layout of the packed tensors.");
+
+    cls.def_property(
+        "schedule",
+        &S::schedule,
+        &S::set_schedule,
+        "Distribution of the items over the threads (setting it copies the state).");
+
+    cls.def_property(
+        "eigensolver",
+        &S::eigensolver,
+        &S::set_eigensolver,
+        "Eigensolver used by refresh (setting it resets eigensolver_fallbacks).");
+
+    cls.def_property_readonly(
+        "eigensolver_fallbacks",
+        &S::eigensolver_fallbacks,
+        "Number of fallbacks to the default eigensolver.");
 
     cls.def_property(
         "F",
@@ -55,6 +134,81 @@ auto Elastic(T& cls)
     cls.def(
         "refresh", &S::refresh, "Recompute stress from strain.", py::arg("compute_tangent") = true);
 
+    cls.def(
+        "refresh_index",
+        &S::template refresh_index<xt::pytensor<size_t, 1>>,
+        "Recompute stress from strain of a subset of items.",
+        py::arg("index"),
+        py::arg("compute_tangent") = true);
+
+    cls.def(
+        "refresh_mask",
+        &S::template refresh_mask<xt::pytensor<bool, S::rank>>,
+        "Recompute stress from strain of the items selected by a mask.",
+        py::arg("mask"),
+        py::arg("compute_tangent") = true);
+
+    cls.def(
+        "refresh_element",
+        &S::template refresh_element<
+            xt::pytensor<double, S::rank + 2>,
+            xt::pytensor<double, S::rank>,
+            xt::pytensor<double, 3>>,
+        "Recompute stress and tangent, and assemble element force and stiffness.",
+        py::arg("dNdx"),
+        py::arg("dV"),
+        py::arg("fe"),
+        py::arg("Ke"));
+
+    cls.def(
+        "evaluate_trial",
+        &S::template evaluate_trial<
+            xt::pytensor<double, S::rank + 2>,
+            xt::pytensor<double, S::rank + 2>>,
+        "Stress for a candidate deformation gradient, without modifying the object.",
+        py::arg("F"),
+        py::arg("Sig"));
+
+    cls.def(
+        "evaluate_trial",
+        &S::template evaluate_trial<
+            xt::pytensor<double, S::rank + 2>,
+            xt::pytensor<double, S::rank + 2>,
+            xt::pytensor<double, S::rank>>,
+        "Stress for a candidate deformation gradient, and ``P : dF`` per item.",
+        py::arg("F"),
+        py::arg("dF"),
+        py::arg("Sig"),
+        py::arg("work"));
+
+    cls.def(
+        "set_F_index",
+        &S::template set_F_index<xt::pytensor<size_t, 1>, xt::pytensor<double, 3>>,
+        "Overwrite deformation gradient tensor of a subset of items.",
+        py::arg("index"),
+        py::arg("arg"),
+        py::arg("compute_tangent") = true);
+
+    cls.def_property(
+        "detect_changes",
+        &S::detect_changes,
+        &S::set_detect_changes,
+        "Let set_F only recompute the items whose deformation gradient changed.");
+
+    cls.def_property(
+        "outputs",
+        [](const S& self) { return static_cast<unsigned>(self.outputs()); },
+        [](S& self, unsigned arg) { self.set_outputs(static_cast<decltype(self.outputs())>(arg)); },
+        "Derived outputs computed by refresh (combination of Output flags).");
+
+    cls.def_property_readonly(
+        "instrumentation", &S::instrumentation, "Counters of the last update of the stress.");
+
+    cls.def_property_readonly("sigeq", &S::sigeq, "Equivalent stress (Output.Sigeq).");
+    cls.def_property_readonly("epseq", &S::epseq, "Equivalent strain (Output.Epseq).");
+    cls.def_property_readonly("J", &S::J, "Volume change ratio (Output.J).");
+    cls.def_property_readonly("energy", &S::energy, "Stored elastic energy (Output.Energy).");
+
     cls.def("__repr__", [](const S&) { return "<GMat...Simo.Cartesian3d.Elastic>"; });
 }
 
@@ -73,16 +227,114 @@ auto LinearHardening(T& cls)
         py::arg("tauy0"),
         py::arg("H"));
 
+    cls.def(
+        py::init<const std::array<size_t, S::rank>&, double, double, double, double>(),
+        "Homogeneous system.",
+        py::arg("shape"),
+        py::arg("K"),
+        py::arg("G"),
+        py::arg("tauy0"),
+        py::arg("H"));
+
+    cls.def(
+        py::init<
+            const xt::pytensor<size_t, S::rank>&,
+            const xt::pytensor<double, 1>&,
+            const xt::pytensor<double, 1>&,
+            const xt::pytensor<double, 1>&,
+            const xt::pytensor<double, 1>&>(),
+        "System of phases.",
+        py::arg("phase"),
+        py::arg("K"),
+        py::arg("G"),
+        py::arg("tauy0"),
+        py::arg("H"));
+
     cls.def_property_readonly("shape", &S::shape, "Shape of array.");
     cls.def_property_readonly("shape_tensor2", &S::shape_tensor2, "Array of rank 2 tensors.");
     cls.def_property_readonly("shape_tensor4", &S::shape_tensor4, "Array of rank 4 tensors.");
-    cls.def_property_readonly("K", &S::K, "Bulk modulus.");
-    cls.def_property_readonly("G", &S::G, "Shear modulus.");
-    cls.def_property_readonly("tauy0", &S::tauy0, "Initial yield stress.");
-    cls.def_property_readonly("H", &S::H, "Hardening modulus.");
+    cls.def_property_readonly(
+        "parameter_storage", &S::parameter_storage, "Storage of the material parameters.");
+    cls.def_property_readonly("phase", &S::phase, "Index of the parameter set per item.");
+    cls.def_property_readonly("K", &S::K_expanded, "Bulk modulus.");
+    cls.def_property_readonly("G", &S::G_expanded, "Shear modulus.");
+    cls.def_property_readonly("tauy0", &S::tauy0_expanded, "Initial yield stress.");
+    cls.def_property_readonly("H", &S::H_expanded, "Hardening modulus.");
     cls.def_property_readonly("Sig", &S::Sig, "Cauchy stress tensor.");
-    cls.def_property_readonly("C", &S::C, "Tangent tensor.");
+    cls.def_property_readonly("Sig_packed", &S::Sig_packed, "Cauchy stress tensor (packed).");
+    cls.def_property_readonly(
+        "C",
+        [](py::object obj) -> py::object {
+            S& self = obj.cast<S&>();
+            // with the Mandel storage the full tangent is reconstructed in a new array
+            if (self.tangent_storage() == decltype(self.tangent_storage())::Full) {
+                return py::cast(self.C(), py::return_value_policy::reference_internal, obj);
+            }
+            return py::cast(self.C_expanded());
+        },
+        "Tangent tensor (computed if the last refresh did not).");
+
+    cls.def_property_readonly(
+        "C_mandel",
+        static_cast<const xt::pytensor<typename S::tangent_type, S::rank + 2>& (S::*)()>(
+            &S::C_mandel),
+        "Symmetric part of the tangent in Mandel notation (computed if the last refresh did not).");
+
+    cls.def_property_readonly("shape_packed", &S::shape_packed, "Array of packed tensors.");
+    cls.def_property_readonly("shape_mandel", &S::shape_mandel, "Array of Mandel matrices.");
+
+    cls.def_property(
+        "tangent_storage",
+        &S::tangent_storage,
+        &S::set_tangent_storage,
+        "Storage of the tangent computed by refresh.");
+
+    cls.def_property_readonly(
+        "tangent_policy", &S::tangent_policy, "Tangent computed by refresh (modified Newton).");
+
+    cls.def_property_readonly(
+        "tangent_interval", &S::tangent_interval, "Interval of TangentPolicy.Interval.");
+
+    cls.def(
+        "set_tangent_policy",
+        &S::set_tangent_policy,
+        "Set the tangent computed by refresh.",
+        py::arg("policy"),
+        py::arg("interval") = 1);
+
+    cls.def_property(
+        "layout", &S::layout, &S::set_layout, "Memory layout of the packed tensors.");
+
+    cls.def_property(
+        "schedule",
+        &S::schedule,
+        &S::set_schedule,
+        "Distribution of the items over the threads (setting it copies the state).");
+
+    cls.def_property(
+        "plastic_cost",
+        &S::plastic_cost,
+        &S::set_plastic_cost,
+        "Relative cost of an item that yields (used by Schedule.Balanced).");
+
+    cls.def_property(
+        "eigensolver",
+        &S::eigensolver,
+        &S::set_eigensolver,
+        "Eigensolver used by refresh (setting it resets eigensolver_fallbacks).");
+
+    cls.def_property_readonly(
+        "eigensolver_fallbacks",
+        &S::eigensolver_fallbacks,
+        "Number of fallbacks to the default eigensolver.");
+    cls.def_property_readonly("Be", &S::Be, "Elastic Finger tensor.");
+    cls.def_property_readonly("Be_packed", &S::Be_packed, "Elastic Finger tensor (packed).");
     cls.def_property_readonly("epsp", &S::epsp, "Plastic strain.");
+    cls.def_property_readonly("plastic", &S::plastic, "Items that are yielding.");
+    cls.def_property_readonly(
+        "plastic_t", &S::plastic_t, "Items that yielded in the last increment.");
+    cls.def_property_readonly(
+        "plastic_index", &S::plastic_index, "Flat indices of the items that are yielding.");
 
     cls.def_property(
         "F",
@@ -101,7 +353,87 @@ auto LinearHardening(T& cls)
     cls.def(
         "refresh", &S::refresh, "Recompute stress from strain.", py::arg("compute_tangent") = true);
 
+    cls.def(
+        "refresh_index",
+        &S::template refresh_index<xt::pytensor<size_t, 1>>,
+        "Recompute stress from strain of a subset of items.",
+        py::arg("index"),
+        py::arg("compute_tangent") = true);
+
+    cls.def(
+        "refresh_mask",
+        &S::template refresh_mask<xt::pytensor<bool, S::rank>>,
+        "Recompute stress from strain of the items selected by a mask.",
+        py::arg("mask"),
+        py::arg("compute_tangent") = true);
+
+    cls.def(
+        "refresh_element",
+        &S::template refresh_element<
+            xt::pytensor<double, S::rank + 2>,
+            xt::pytensor<double, S::rank>,
+            xt::pytensor<double, 3>>,
+        "Recompute stress and tangent, and assemble element force and stiffness.",
+        py::arg("dNdx"),
+        py::arg("dV"),
+        py::arg("fe"),
+        py::arg("Ke"));
+
+    cls.def(
+        "evaluate_trial",
+        &S::template evaluate_trial<
+            xt::pytensor<double, S::rank + 2>,
+            xt::pytensor<double, S::rank + 2>>,
+        "Stress for a candidate deformation gradient, without modifying the object.",
+        py::arg("F"),
+        py::arg("Sig"));
+
+    cls.def(
+        "evaluate_trial",
+        &S::template evaluate_trial<
+            xt::pytensor<double, S::rank + 2>,
+            xt::pytensor<double, S::rank + 2>,
+            xt::pytensor<double, S::rank>>,
+        "Stress for a candidate deformation gradient, and ``P : dF`` per item.",
+        py::arg("F"),
+        py::arg("dF"),
+        py::arg("Sig"),
+        py::arg("work"));
+
+    cls.def(
+        "set_F_index",
+        &S::template set_F_index<xt::pytensor<size_t, 1>, xt::pytensor<double, 3>>,
+        "Overwrite deformation gradient tensor of a subset of items.",
+        py::arg("index"),
+        py::arg("arg"),
+        py::arg("compute_tangent") = true);
+
+    cls.def_property(
+        "detect_changes",
+        &S::detect_changes,
+        &S::set_detect_changes,
+        "Let set_F only recompute the items whose deformation gradient changed.");
+
+    cls.def_property(
+        "outputs",
+        [](const S& self) { return static_cast<unsigned>(self.outputs()); },
+        [](S& self, unsigned arg) { self.set_outputs(static_cast<decltype(self.outputs())>(arg)); },
+        "Derived outputs computed by refresh (combination of Output flags).");
+
+    cls.def_property_readonly(
+        "instrumentation", &S::instrumentation, "Counters of the last update of the stress.");
+
+    cls.def_property_readonly("sigeq", &S::sigeq, "Equivalent stress (Output.Sigeq).");
+    cls.def_property_readonly("epseq", &S::epseq, "Equivalent strain (Output.Epseq).");
+    cls.def_property_readonly("J", &S::J, "Volume change ratio (Output.J).");
+    cls.def_property_readonly("energy", &S::energy, "Stored elastic energy (Output.Energy).");
+
+    cls.def_property_readonly(
+        "dissipation", &S::dissipation, "Plastic dissipation of increment (Output.Dissipation).");
+
     cls.def("increment", &S::increment, "Update history variables.");
+
+    cls.def("rollback", &S::rollback, "Restore the state of the last increment.");
     cls.def("__repr__", [](const S&) { return "<GMat...Simo.Cartesian3d.LinearHardening>"; });
 }
 
@@ -169,6 +501,95 @@ void strain(M& mod)
         py::arg("ret"));
 }
 
+template <class M>
+void pointer(M& mod)
+{
+    namespace SM = GMatElastoPlasticFiniteStrainSimo::Cartesian3d;
+
+    mod.def(
+        "elastic_stress_tangent",
+        [](double K,
+           double G,
+           const xt::pytensor<double, 2>& F,
+           xt::pytensor<double, 2>& Sig,
+           xt::pytensor<double, 4>& C,
+           SM::Eigensolver solver) {
+            GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(F.size() == 9);
+            GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(Sig.size() == 9);
+            GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(C.size() == 81);
+            SM::pointer::elastic_stress_tangent(K, G, F.data(), Sig.data(), C.data(), solver);
+        },
+        "Stress and tangent of one point of the elastic model.",
+        py::arg("K"),
+        py::arg("G"),
+        py::arg("F"),
+        py::arg("Sig"),
+        py::arg("C"),
+        py::arg("solver") = SM::Eigensolver::Default);
+
+    mod.def(
+        "linear_hardening_history",
+        [](const xt::pytensor<double, 2>& F_t,
+           const xt::pytensor<double, 2>& Be_t,
+           xt::pytensor<double, 2>& Cpinv_t) {
+            GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(F_t.size() == 9);
+            GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(Be_t.size() == 9);
+            GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(Cpinv_t.size() == 9);
+            SM::pointer::linear_hardening_history(F_t.data(), Be_t.data(), Cpinv_t.data());
+        },
+        "History of one point of the linear hardening model (once per increment).",
+        py::arg("F_t"),
+        py::arg("Be_t"),
+        py::arg("Cpinv_t"));
+
+    mod.def(
+        "linear_hardening_stress_tangent",
+        [](double K,
+           double G,
+           double tauy0,
+           double H,
+           const xt::pytensor<double, 2>& F,
+           const xt::pytensor<double, 2>& Cpinv_t,
+           double epsp_t,
+           xt::pytensor<double, 2>& Sig,
+           xt::pytensor<double, 2>& Be,
+           xt::pytensor<double, 4>& C,
+           SM::Eigensolver solver) {
+            GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(F.size() == 9);
+            GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(Cpinv_t.size() == 9);
+            GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(Sig.size() == 9);
+            GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(Be.size() == 9);
+            GMATELASTOPLASTICFINITESTRAINSIMO_ASSERT(C.size() == 81);
+            double epsp;
+            SM::pointer::linear_hardening_stress_tangent(
+                K,
+                G,
+                tauy0,
+                H,
+                F.data(),
+                Cpinv_t.data(),
+                epsp_t,
+                Sig.data(),
+                Be.data(),
+                epsp,
+                C.data(),
+                solver);
+            return epsp;
+        },
+        "Stress and tangent of one point of the linear hardening model (returns epsp).",
+        py::arg("K"),
+        py::arg("G"),
+        py::arg("tauy0"),
+        py::arg("H"),
+        py::arg("F"),
+        py::arg("Cpinv_t"),
+        py::arg("epsp_t"),
+        py::arg("Sig"),
+        py::arg("Be"),
+        py::arg("C"),
+        py::arg("solver") = SM::Eigensolver::Default);
+}
+
 } // namespace my3d
 
 /**
@@ -241,6 +662,87 @@ PYBIND11_MODULE(_GMatElastoPlasticFiniteStrainSimo, m)
     my3d::strain<xt::pytensor<double, 3>, xt::pytensor<double, 3>>(sm);
     my3d::strain<xt::pytensor<double, 2>, xt::pytensor<double, 2>>(sm);
 
+    // Tangent storage
+
+    py::enum_<SM::TangentStorage>(sm, "TangentStorage")
+        .value("Full", SM::TangentStorage::Full)
+        .value("Mandel", SM::TangentStorage::Mandel)
+        .export_values();
+
+    // Tangent policy
+
+    py::enum_<SM::TangentPolicy>(sm, "TangentPolicy")
+        .value("Consistent", SM::TangentPolicy::Consistent)
+        .value("Frozen", SM::TangentPolicy::Frozen)
+        .value("InitialElastic", SM::TangentPolicy::InitialElastic)
+        .value("Interval", SM::TangentPolicy::Interval)
+        .export_values();
+
+    // Layout
+
+    py::enum_<SM::Layout>(sm, "Layout")
+        .value("AoS", SM::Layout::AoS)
+        .value("SoA", SM::Layout::SoA)
+        .export_values();
+
+    // Schedule
+
+    py::enum_<SM::Schedule>(sm, "Schedule")
+        .value("Static", SM::Schedule::Static)
+        .value("Pinned", SM::Schedule::Pinned)
+        .value("Balanced", SM::Schedule::Balanced)
+        .value("Dynamic", SM::Schedule::Dynamic)
+        .export_values();
+
+    // Eigensolver
+
+    py::enum_<SM::Eigensolver>(sm, "Eigensolver")
+        .value("Default", SM::Eigensolver::Default)
+        .value("Analytic", SM::Eigensolver::Analytic)
+        .value("Jacobi", SM::Eigensolver::Jacobi)
+        .export_values();
+
+    // Stateless functions on raw pointers
+
+    py::module pm = sm.def_submodule("pointer", "Stateless evaluation of one material point");
+    my3d::pointer(pm);
+
+    // ParameterStorage
+
+    py::enum_<SM::ParameterStorage>(sm, "ParameterStorage")
+        .value("Item", SM::ParameterStorage::Item)
+        .value("Phase", SM::ParameterStorage::Phase)
+        .value("Uniform", SM::ParameterStorage::Uniform)
+        .export_values();
+
+    // Instrumentation
+
+    py::class_<SM::Instrumentation>(sm, "Instrumentation")
+        .def_readonly("enabled", &SM::Instrumentation::enabled)
+        .def_readonly("kinematics", &SM::Instrumentation::kinematics)
+        .def_readonly("eigs", &SM::Instrumentation::eigs)
+        .def_readonly("stress", &SM::Instrumentation::stress)
+        .def_readonly("tangent", &SM::Instrumentation::tangent)
+        .def_readonly("items", &SM::Instrumentation::items)
+        .def_readonly("yielded", &SM::Instrumentation::yielded)
+        .def_readonly("degenerate", &SM::Instrumentation::degenerate)
+        .def_readonly("thread_items", &SM::Instrumentation::thread_items)
+        .def_readonly("thread_yielded", &SM::Instrumentation::thread_yielded)
+        .def_readonly("thread_time", &SM::Instrumentation::thread_time)
+        .def("__repr__", [](const SM::Instrumentation&) {
+            return "<GMat...Simo.Cartesian3d.Instrumentation>";
+        });
+
+    // Output
+
+    py::enum_<SM::Output>(sm, "Output", py::arithmetic())
+        .value("None", SM::Output::None)
+        .value("Sigeq", SM::Output::Sigeq)
+        .value("Epseq", SM::Output::Epseq)
+        .value("J", SM::Output::J)
+        .value("Energy", SM::Output::Energy)
+        .value("Dissipation", SM::Output::Dissipation);
+
     // Elastic
 
     {
@@ -259,6 +761,28 @@ PYBIND11_MODULE(_GMatElastoPlasticFiniteStrainSimo, m)
         my3d::Elastic<SM::Elastic<3>>(array3d);
     }
 
+    // Elastic: tangent stored as float
+
+    {
+
+        py::class_<SM::Elastic<0, float>, GMatTensor::Cartesian3d::Array<0>> array0d(
+            sm, "Elastic0dFloat");
+
+        py::class_<SM::Elastic<1, float>, GMatTensor::Cartesian3d::Array<1>> array1d(
+            sm, "Elastic1dFloat");
+
+        py::class_<SM::Elastic<2, float>, GMatTensor::Cartesian3d::Array<2>> array2d(
+            sm, "Elastic2dFloat");
+
+        py::class_<SM::Elastic<3, float>, GMatTensor::Cartesian3d::Array<3>> array3d(
+            sm, "Elastic3dFloat");
+
+        my3d::Elastic<SM::Elastic<0, float>>(array0d);
+        my3d::Elastic<SM::Elastic<1, float>>(array1d);
+        my3d::Elastic<SM::Elastic<2, float>>(array2d);
+        my3d::Elastic<SM::Elastic<3, float>>(array3d);
+    }
+
     // LinearHardening
 
     {
@@ -280,4 +804,26 @@ PYBIND11_MODULE(_GMatElastoPlasticFiniteStrainSimo, m)
         my3d::LinearHardening<SM::LinearHardening<2>>(array2d);
         my3d::LinearHardening<SM::LinearHardening<3>>(array3d);
     }
+
+    // LinearHardening: tangent stored as float
+
+    {
+
+        py::class_<SM::LinearHardening<0, float>, GMatTensor::Cartesian3d::Array<0>> array0d(
+            sm, "LinearHardening0dFloat");
+
+        py::class_<SM::LinearHardening<1, float>, GMatTensor::Cartesian3d::Array<1>> array1d(
+            sm, "LinearHardening1dFloat");
+
+        py::class_<SM::LinearHardening<2, float>, GMatTensor::Cartesian3d::Array<2>> array2d(
+            sm, "LinearHardening2dFloat");
+
+        py::class_<SM::LinearHardening<3, float>, GMatTensor::Cartesian3d::Array<3>> array3d(
+            sm, "LinearHardening3dFloat");
+
+        my3d::LinearHardening<SM::LinearHardening<0, float>>(array0d);
+        my3d::LinearHardening<SM::LinearHardening<1, float>>(array1d);
+        my3d::LinearHardening<SM::LinearHardening<2, float>>(array2d);
+        my3d::LinearHardening<SM::LinearHardening<3, float>>(array3d);
+    }
 }
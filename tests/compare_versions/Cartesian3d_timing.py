@@ -0,0 +1,187 @@
+"""
+Replay the loading history of ``Cartesian3d_random.hdf5`` (see ``Cartesian3d_generate.py``),
+check the result, and record the wall time, the per-increment cost, and the peak memory.
+Each model is replayed in its own process, such that the peak memory is that of one model.
+
+Store a baseline (e.g. using a release)::
+
+    python Cartesian3d_timing.py --write baseline.json
+
+Compare the current build to the baseline (fails if it is slower than the tolerance)::
+
+    python Cartesian3d_timing.py --check baseline.json --tolerance 0.1
+
+Both can be combined to also store the timings of the current build.
+"""
+
+import argparse
+import json
+import subprocess
+import sys
+import time
+
+import GMatElastoPlasticFiniteStrainSimo
+import GMatElastoPlasticFiniteStrainSimo.Cartesian3d as GMat
+import h5py
+import numpy as np
+
+try:
+    import resource
+except ImportError:  # e.g. Windows
+    resource = None
+
+
+def peak_rss():
+    """
+    Peak resident set size of the current process in bytes (``None`` if unknown).
+    """
+    if resource is None:
+        return None
+    ret = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    if sys.platform == "darwin":
+        return ret
+    return ret * 1024
+
+
+def replay(data, model):
+    """
+    Replay the loading history and check the result.
+
+    :param data: Opened ``Cartesian3d_random.hdf5``.
+    :param model: ``"elastic"`` or ``"plastic"``.
+    :return: Wall time per increment [s].
+    """
+    if model == "plastic":
+        mat = GMat.LinearHardening2d(
+            K=data["K"][...], G=data["G"][...], tauy0=data["tauy0"][...], H=data["H"][...]
+        )
+    else:
+        mat = GMat.Elastic2d(K=data["K"][...], G=data["G"][...])
+
+    n = len(data["data"])
+    F = [data[f"/data/{i:d}/F"][...] for i in range(n)]
+    ret = np.empty(n)
+
+    for i in range(n):
+
+        tic = time.perf_counter()
+        if model == "plastic":
+            mat.increment()
+        mat.F = F[i]
+        C = mat.C
+        ret[i] = time.perf_counter() - tic
+
+        assert np.allclose(mat.Sig, data[f"/data/{i:d}/{model}/Stress"][...])
+        assert np.allclose(C, data[f"/data/{i:d}/{model}/Tangent"][...])
+
+    return ret
+
+
+def measure_model(filename, repeat, model):
+    """
+    Time the replay of one model (in the current process).
+
+    :param filename: ``Cartesian3d_random.hdf5``.
+    :param repeat: Number of replays, the fastest time per increment is kept.
+    :param model: ``"elastic"`` or ``"plastic"``.
+    :return: Dictionary with the timings and the peak memory of the process.
+    """
+    with h5py.File(filename, "r") as data:
+        t = np.min([replay(data, model) for _ in range(repeat)], axis=0)
+
+    return {
+        "total": float(np.sum(t)),
+        "per_increment": t.tolist(),
+        "peak_rss": peak_rss(),
+    }
+
+
+def measure(filename, repeat):
+    """
+    Time the replay of all models, each in a separate process.
+
+    :param filename: ``Cartesian3d_random.hdf5``.
+    :param repeat: Number of replays, the fastest time per increment is kept.
+    :return: Dictionary with the timings.
+    """
+    ret = {"version": GMatElastoPlasticFiniteStrainSimo.version(), "models": {}}
+
+    for model in ["elastic", "plastic"]:
+        cmd = [sys.executable, __file__, "--data", filename, "--repeat", str(repeat)]
+        out = subprocess.run(cmd + ["--model", model], check=True, capture_output=True, text=True)
+        ret["models"][model] = json.loads(out.stdout)
+
+    return ret
+
+
+def compare(baseline, current, tolerance, tolerance_memory):
+    """
+    Compare timings to a baseline.
+
+    :param baseline: Output of :py:func:`measure` for the baseline.
+    :param current: Output of :py:func:`measure` for the current build.
+    :param tolerance: Allowed relative slow-down.
+    :param tolerance_memory: Allowed relative increase of the peak memory (per model).
+    :return: List of failures (empty if the current build is not slower).
+    """
+    ret = []
+
+    for model, b in baseline["models"].items():
+        c = current["models"][model]
+        ratio = c["total"] / b["total"]
+        per_increment = np.median(np.array(c["per_increment"]) / np.array(b["per_increment"]))
+        print(f"{model}: {ratio:.3f} x baseline (per increment, median: {per_increment:.3f} x)")
+        if ratio > 1 + tolerance:
+            ret.append(f"{model}: {ratio:.3f} times slower than baseline")
+
+        if b.get("peak_rss") is not None and c["peak_rss"] is not None:
+            ratio = c["peak_rss"] / b["peak_rss"]
+            print(f"{model}: peak memory {ratio:.3f} x baseline")
+            if ratio > 1 + tolerance_memory:
+                ret.append(f"{model}: peak memory {ratio:.3f} times that of baseline")
+
+    return ret
+
+
+def main():
+
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--data", default="Cartesian3d_random.hdf5", help="Loading history")
+    parser.add_argument("--repeat", type=int, default=5, help="Number of replays")
+    parser.add_argument("--tolerance", type=float, default=0.1, help="Allowed slow-down")
+    parser.add_argument("--tolerance-memory", type=float, default=0.1, help="Allowed memory")
+    parser.add_argument("--write", help="Store timings as baseline (JSON)")
+    parser.add_argument("--check", help="Compare timings to baseline (JSON)")
+    parser.add_argument("--model", help=argparse.SUPPRESS)  # internal: time one model
+    args = parser.parse_args()
+
+    if args.model:
+        json.dump(measure_model(args.data, args.repeat, args.model), sys.stdout)
+        return 0
+
+    if not args.write and not args.check:
+        parser.error("specify --write and/or --check")
+
+    current = measure(args.data, args.repeat)
+
+    if args.write:
+        with open(args.write, "w") as file:
+            json.dump(current, file, indent=2)
+
+    if not args.check:
+        return 0
+
+    with open(args.check) as file:
+        baseline = json.load(file)
+
+    failures = compare(baseline, current, args.tolerance, args.tolerance_memory)
+
+    for failure in failures:
+        print(f"PERFORMANCE REGRESSION: {failure}", file=sys.stderr)
+
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+
+    sys.exit(main())
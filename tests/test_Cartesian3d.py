@@ -5,6 +5,15 @@ import GMatTensor.Cartesian3d as tensor
 import numpy as np
 
 
+def energy(K, G, Eps):
+    """
+    Elastic energy per unit reference volume: ``4.5 * K * epsm**2 + G * epsd : epsd``.
+    """
+    epsm = np.trace(Eps, axis1=-2, axis2=-1) / 3
+    Epsd = Eps - epsm[..., np.newaxis, np.newaxis] * np.eye(3)
+    return 4.5 * K * epsm**2 + G * np.einsum("...ij,...ij", Epsd, Epsd)
+
+
 class Test_main(unittest.TestCase):
     """ """
 
@@ -51,6 +60,731 @@ class Test_main(unittest.TestCase):
 
         self.assertTrue(np.allclose(mat.Sig, Sig))
 
+    def test_LinearHardening_stress_only(self):
+
+        shape = [2, 3]
+        mat = GMat.LinearHardening2d(
+            K=np.random.random(shape),
+            G=np.random.random(shape),
+            tauy0=1e-6 * np.random.random(shape),
+            H=np.random.random(shape),
+        )
+        ref = GMat.LinearHardening2d(K=mat.K, G=mat.G, tauy0=mat.tauy0, H=mat.H)
+
+        F = tensor.Array2d(shape).I2 + 0.1 * np.random.random(shape + [3, 3])
+        mat.set_F(F, compute_tangent=False)
+        ref.set_F(F)
+
+        self.assertTrue(np.allclose(mat.Sig, ref.Sig))
+        self.assertTrue(np.allclose(mat.epsp, ref.epsp))
+        self.assertTrue(np.all(mat.epsp > 0))
+        self.assertTrue(np.allclose(mat.C, ref.C))
+
+    def test_LinearHardening_mandel(self):
+
+        shape = [2, 3]
+        mat = GMat.LinearHardening2d(
+            K=np.random.random(shape),
+            G=np.random.random(shape),
+            tauy0=1e-6 * np.random.random(shape),
+            H=np.random.random(shape),
+        )
+        mat.tangent_storage = GMat.TangentStorage.Mandel
+        ref = GMat.LinearHardening2d(K=mat.K, G=mat.G, tauy0=mat.tauy0, H=mat.H)
+
+        F = tensor.Array2d(shape).I2 + 0.1 * np.random.random(shape + [3, 3])
+        mat.F = F
+        ref.F = F
+
+        self.assertEqual(list(mat.C_mandel.shape), mat.shape_mandel)
+        self.assertTrue(np.allclose(mat.C_mandel, np.einsum("...ij->...ji", mat.C_mandel)))
+        self.assertTrue(np.allclose(mat.C_mandel, ref.C_mandel))
+        self.assertTrue(np.allclose(mat.C, ref.C))
+
+    def test_Elastic_mandel(self):
+
+        shape = [2, 3]
+        mat = GMat.Elastic2d(K=np.random.random(shape), G=np.random.random(shape))
+        mat.tangent_storage = GMat.TangentStorage.Mandel
+        ref = GMat.Elastic2d(K=mat.K, G=mat.G)
+
+        F = tensor.Array2d(shape).I2 + 0.1 * np.random.random(shape + [3, 3])
+        mat.F = F
+        ref.F = F
+
+        self.assertEqual(list(mat.C_mandel.shape), mat.shape_mandel)
+        self.assertTrue(np.allclose(mat.C_mandel, np.einsum("...ij->...ji", mat.C_mandel)))
+        self.assertTrue(np.allclose(mat.C_mandel, ref.C_mandel))
+        self.assertTrue(np.allclose(mat.C, ref.C))
+
+    def test_LinearHardening_packed(self):
+
+        shape = [2, 3]
+        mat = GMat.LinearHardening2d(
+            K=np.random.random(shape),
+            G=np.random.random(shape),
+            tauy0=1e6 * np.ones(shape),
+            H=np.random.random(shape),
+        )
+
+        F = tensor.Array2d(shape).I2 + 0.1 * np.random.random(shape + [3, 3])
+        mat.F = F
+
+        Be = np.einsum("...ik,...jk->...ij", F, F)
+        self.assertTrue(np.allclose(mat.Be, Be))
+
+        for Sig, packed in zip([mat.Sig, mat.Be], [mat.Sig_packed, mat.Be_packed]):
+            self.assertEqual(list(packed.shape), mat.shape_packed)
+            for i, (m, n) in enumerate([(0, 0), (1, 1), (2, 2), (1, 2), (0, 2), (0, 1)]):
+                self.assertTrue(np.allclose(packed[..., i], Sig[..., m, n]))
+                self.assertTrue(np.allclose(packed[..., i], Sig[..., n, m]))
+
+    def test_LinearHardening_layout(self):
+
+        shape = [2, 3]
+        mat = GMat.LinearHardening2d(
+            K=np.random.random(shape),
+            G=np.random.random(shape),
+            tauy0=1e-3 * np.random.random(shape),
+            H=np.random.random(shape),
+        )
+        mat.layout = GMat.Layout.SoA
+        ref = GMat.LinearHardening2d(K=mat.K, G=mat.G, tauy0=mat.tauy0, H=mat.H)
+        self.assertEqual(list(mat.Sig_packed.shape), [6] + shape)
+
+        for i in range(5):
+            F = tensor.Array2d(shape).I2 + 0.02 * i * np.random.random(shape + [3, 3])
+            mat.F = F
+            ref.F = F
+            self.assertTrue(np.allclose(mat.Sig, ref.Sig))
+            self.assertTrue(np.allclose(mat.Be, ref.Be))
+            self.assertTrue(np.allclose(mat.epsp, ref.epsp))
+            self.assertTrue(np.allclose(mat.C, ref.C))
+            self.assertTrue(np.allclose(np.moveaxis(mat.Sig_packed, 0, -1), ref.Sig_packed))
+            mat.increment()
+            ref.increment()
+
+        self.assertTrue(np.any(mat.epsp > 0))
+
+    def test_Elastic_layout(self):
+
+        shape = [2, 3]
+        mat = GMat.Elastic2d(K=np.random.random(shape), G=np.random.random(shape))
+        mat.layout = GMat.Layout.SoA
+        ref = GMat.Elastic2d(K=mat.K, G=mat.G)
+        self.assertEqual(list(mat.Sig_packed.shape), [6] + shape)
+
+        for i in range(3):
+            F = tensor.Array2d(shape).I2 + 0.02 * i * np.random.random(shape + [3, 3])
+            mat.F = F
+            ref.F = F
+            self.assertTrue(np.allclose(mat.Sig, ref.Sig))
+            self.assertTrue(np.allclose(mat.C, ref.C))
+            self.assertTrue(np.allclose(np.moveaxis(mat.Sig_packed, 0, -1), ref.Sig_packed))
+
+    def test_LinearHardening_plastic(self):
+
+        shape = [2, 3]
+        mat = GMat.LinearHardening2d(
+            K=np.random.random(shape),
+            G=np.random.random(shape),
+            tauy0=1e-2 * np.random.random(shape),
+            H=np.random.random(shape),
+        )
+        self.assertFalse(np.any(mat.plastic))
+
+        for i in range(5):
+            epsp_t = np.copy(mat.epsp)
+            mat.F = tensor.Array2d(shape).I2 + 0.01 * i * np.random.random(shape + [3, 3])
+            plastic = mat.epsp > epsp_t
+            self.assertTrue(np.all(mat.plastic == plastic))
+            self.assertTrue(np.all(mat.plastic_index == np.flatnonzero(plastic)))
+            mat.increment()
+            self.assertTrue(np.all(mat.plastic_t == plastic))
+
+        self.assertTrue(np.any(mat.plastic_t))
+
+    def test_LinearHardening_tangent_policy(self):
+
+        shape = [2, 3]
+        ref = GMat.LinearHardening2d(
+            K=np.random.random(shape),
+            G=np.random.random(shape),
+            tauy0=1e-2 * np.random.random(shape),
+            H=np.random.random(shape),
+        )
+        C0 = np.copy(ref.C)
+        self.assertEqual(ref.tangent_policy, GMat.TangentPolicy.Consistent)
+
+        frozen = GMat.LinearHardening2d(K=ref.K, G=ref.G, tauy0=ref.tauy0, H=ref.H)
+        frozen.set_tangent_policy(GMat.TangentPolicy.Frozen)
+        initial = GMat.LinearHardening2d(K=ref.K, G=ref.G, tauy0=ref.tauy0, H=ref.H)
+        initial.set_tangent_policy(GMat.TangentPolicy.InitialElastic)
+        interval = GMat.LinearHardening2d(K=ref.K, G=ref.G, tauy0=ref.tauy0, H=ref.H)
+        interval.set_tangent_policy(GMat.TangentPolicy.Interval, 2)
+        self.assertEqual(interval.tangent_interval, 2)
+
+        for i in range(1, 4):
+            for j in range(3):
+                F = tensor.Array2d(shape).I2 + 0.01 * i * np.random.random(shape + [3, 3])
+                for mat in [ref, frozen, initial, interval]:
+                    mat.F = F
+                    self.assertTrue(np.allclose(mat.Sig, ref.Sig))
+                if j == 0:
+                    C = np.copy(ref.C)
+                self.assertTrue(np.allclose(frozen.C, C))
+                self.assertTrue(np.allclose(initial.C, C0))
+                if j % 2 == 0:
+                    C_interval = np.copy(ref.C)
+                self.assertTrue(np.allclose(interval.C, C_interval))
+            for mat in [ref, frozen, initial, interval]:
+                mat.increment()
+
+    def test_LinearHardening_tangent_policy_mandel(self):
+
+        shape = [2, 3]
+        K = np.random.random(shape)
+        G = np.random.random(shape)
+        tauy0 = 1e-2 * np.random.random(shape)
+        H = np.random.random(shape)
+
+        for policy in [
+            GMat.TangentPolicy.Consistent,
+            GMat.TangentPolicy.Frozen,
+            GMat.TangentPolicy.InitialElastic,
+            GMat.TangentPolicy.Interval,
+        ]:
+            full = GMat.LinearHardening2d(K=K, G=G, tauy0=tauy0, H=H)
+            mandel = GMat.LinearHardening2d(K=K, G=G, tauy0=tauy0, H=H)
+            mandel.tangent_storage = GMat.TangentStorage.Mandel
+            for mat in [full, mandel]:
+                mat.set_tangent_policy(policy, 2)
+
+            for i in range(1, 4):
+                for j in range(3):
+                    F = tensor.Array2d(shape).I2 + 0.01 * i * np.random.random(shape + [3, 3])
+                    for mat in [full, mandel]:
+                        mat.F = F
+                    self.assertTrue(np.allclose(mandel.C, full.C))
+                    self.assertTrue(np.allclose(mandel.C_mandel, full.C_mandel))
+                for mat in [full, mandel]:
+                    mat.increment()
+
+    def test_LinearHardening_tangent_policy_stress_only(self):
+
+        shape = [2, 3]
+        ref = GMat.LinearHardening2d(
+            K=np.random.random(shape),
+            G=np.random.random(shape),
+            tauy0=1e-2 * np.random.random(shape),
+            H=np.random.random(shape),
+        )
+        mat = GMat.LinearHardening2d(K=ref.K, G=ref.G, tauy0=ref.tauy0, H=ref.H)
+        mat.set_tangent_policy(GMat.TangentPolicy.Interval, 2)
+        I2 = tensor.Array2d(shape).I2
+
+        F = I2 + 0.01 * np.random.random(shape + [3, 3])
+        for m in [ref, mat]:
+            m.F = F
+        C = np.copy(ref.C)
+        self.assertTrue(np.allclose(mat.C, C))
+
+        # requesting the tangent after a stress-only update is not counted as a "refresh(true)"
+        mat.set_F(I2 + 0.02 * np.random.random(shape + [3, 3]), False)
+        self.assertTrue(np.allclose(mat.C, C))
+        mat.F = I2 + 0.03 * np.random.random(shape + [3, 3])
+        self.assertTrue(np.allclose(mat.C, C))
+
+        F = I2 + 0.04 * np.random.random(shape + [3, 3])
+        for m in [ref, mat]:
+            m.F = F
+        self.assertTrue(np.allclose(mat.C, ref.C))
+
+    def test_LinearHardening_tangent_policy_element(self):
+
+        nelem, nip, nne = 3, 4, 4
+        shape = [nelem, nip]
+        args = dict(
+            K=np.random.random(shape),
+            G=np.random.random(shape),
+            tauy0=1e-2 * np.random.random(shape),
+            H=np.random.random(shape),
+        )
+        dNdx = np.random.random(shape + [nne, 3]) - 0.5
+        dV = np.random.random(shape)
+        fe = np.empty([nelem, nne, 3])
+        Ke = np.empty([nelem, nne * 3, nne * 3])
+
+        for policy in [
+            GMat.TangentPolicy.Consistent,
+            GMat.TangentPolicy.Frozen,
+            GMat.TangentPolicy.InitialElastic,
+            GMat.TangentPolicy.Interval,
+        ]:
+            mat = GMat.LinearHardening2d(**args)
+            elem = GMat.LinearHardening2d(**args)
+            for m in [mat, elem]:
+                m.set_tangent_policy(policy, 2)
+
+            for i in range(1, 3):
+                for j in range(3):
+                    F = tensor.Array2d(shape).I2 + 0.01 * i * np.random.random(shape + [3, 3])
+                    mat.F = F
+                    elem.set_F(F, False)
+                    elem.refresh_element(dNdx, dV, fe, Ke)
+                    f = np.einsum("eqac,eqcd,eq->ead", dNdx, mat.Sig, dV).reshape(fe.shape)
+                    K = np.einsum("eqac,eqcdgf,eqbf,eq->eadbg", dNdx, mat.C, dNdx, dV)
+                    self.assertTrue(np.allclose(fe, f))
+                    self.assertTrue(np.allclose(Ke, K.reshape(Ke.shape)))
+                    self.assertTrue(np.allclose(elem.C, mat.C))
+                for m in [mat, elem]:
+                    m.increment()
+
+    def test_LinearHardening_evaluate_trial(self):
+
+        shape = [2, 3]
+        mat = GMat.LinearHardening2d(
+            K=np.random.random(shape),
+            G=np.random.random(shape),
+            tauy0=1e-2 * np.random.random(shape),
+            H=np.random.random(shape),
+        )
+        ref = GMat.LinearHardening2d(K=mat.K, G=mat.G, tauy0=mat.tauy0, H=mat.H)
+
+        for i in range(1, 4):
+            F = tensor.Array2d(shape).I2 + 0.01 * i * np.random.random(shape + [3, 3])
+            mat.F = F
+            Sig = np.copy(mat.Sig)
+            epsp = np.copy(mat.epsp)
+
+            Fc = F + 0.01 * np.random.random(shape + [3, 3])
+            dF = np.random.random(shape + [3, 3])
+            Sig_trial = np.empty(shape + [3, 3])
+            work = np.empty(shape)
+            mat.evaluate_trial(Fc, dF, Sig_trial, work)
+
+            self.assertTrue(np.allclose(mat.F, F))
+            self.assertTrue(np.allclose(mat.Sig, Sig))
+            self.assertTrue(np.allclose(mat.epsp, epsp))
+
+            ref.F = Fc
+            self.assertTrue(np.allclose(Sig_trial, ref.Sig))
+            J = np.linalg.det(Fc)[..., np.newaxis, np.newaxis]
+            P = np.einsum("...ij,...kj->...ik", J * ref.Sig, np.linalg.inv(Fc))
+            self.assertTrue(np.allclose(work, np.einsum("...ij,...ij", P, dF)))
+
+            mat.evaluate_trial(F, Sig_trial)
+            self.assertTrue(np.allclose(Sig_trial, Sig))
+
+            mat.increment()
+            ref.F = F
+            ref.increment()
+
+    def test_LinearHardening_schedule(self):
+
+        shape = [20, 8]
+        ref = GMat.LinearHardening2d(
+            K=np.random.random(shape),
+            G=np.random.random(shape),
+            tauy0=1e-3 * np.random.random(shape),
+            H=np.random.random(shape),
+        )
+        self.assertEqual(ref.schedule, GMat.Schedule.Static)
+
+        mats = []
+        for schedule in [GMat.Schedule.Pinned, GMat.Schedule.Balanced, GMat.Schedule.Dynamic]:
+            mat = GMat.LinearHardening2d(K=ref.K, G=ref.G, tauy0=ref.tauy0, H=ref.H)
+            mat.schedule = schedule
+            self.assertEqual(mat.schedule, schedule)
+            mats.append(mat)
+
+        mats[1].plastic_cost = 4.0
+
+        for i in range(5):
+            F = tensor.Array2d(shape).I2 + 0.02 * i * np.random.random(shape + [3, 3])
+            ref.F = F
+            for mat in mats:
+                mat.F = F
+                self.assertTrue(np.allclose(mat.Sig, ref.Sig))
+                self.assertTrue(np.allclose(mat.epsp, ref.epsp))
+                self.assertTrue(np.allclose(mat.C, ref.C))
+                mat.increment()
+            ref.increment()
+
+        self.assertTrue(np.any(ref.epsp > 0))
+
+    def test_LinearHardening_eigensolver(self):
+
+        shape = [2, 3]
+        ref = GMat.LinearHardening2d(
+            K=np.random.random(shape),
+            G=np.random.random(shape),
+            tauy0=1e-3 * np.random.random(shape),
+            H=np.random.random(shape),
+        )
+
+        mats = []
+        for solver in [GMat.Eigensolver.Analytic, GMat.Eigensolver.Jacobi]:
+            mat = GMat.LinearHardening2d(K=ref.K, G=ref.G, tauy0=ref.tauy0, H=ref.H)
+            mat.eigensolver = solver
+            mats.append(mat)
+
+        for i in range(5):
+            F = tensor.Array2d(shape).I2 + 0.02 * i * np.random.random(shape + [3, 3])
+            ref.F = F
+            for mat in mats:
+                mat.F = F
+                self.assertTrue(np.allclose(mat.Sig, ref.Sig))
+                self.assertTrue(np.allclose(mat.Be, ref.Be))
+                self.assertTrue(np.allclose(mat.epsp, ref.epsp))
+                self.assertTrue(np.allclose(mat.C, ref.C))
+                mat.increment()
+            ref.increment()
+
+        for mat in mats:
+            self.assertEqual(mat.eigensolver_fallbacks, 0)
+
+    def test_LinearHardening_rollback(self):
+
+        shape = [2, 3]
+        mat = GMat.LinearHardening2d(
+            K=np.random.random(shape),
+            G=np.random.random(shape),
+            tauy0=1e-3 * np.random.random(shape),
+            H=np.random.random(shape),
+        )
+
+        F = tensor.Array2d(shape).I2 + 0.05 * np.random.random(shape + [3, 3])
+        mat.F = F
+        mat.increment()
+        Sig = np.copy(mat.Sig)
+        Be = np.copy(mat.Be)
+        epsp = np.copy(mat.epsp)
+        C = np.copy(mat.C)
+        self.assertTrue(np.any(epsp > 0))
+
+        mat.F = F + 0.05 * np.random.random(shape + [3, 3])
+        self.assertFalse(np.allclose(mat.epsp, epsp))
+        mat.rollback()
+
+        self.assertTrue(np.allclose(mat.F, F))
+        self.assertTrue(np.allclose(mat.Sig, Sig))
+        self.assertTrue(np.allclose(mat.Be, Be))
+        self.assertTrue(np.allclose(mat.epsp, epsp))
+        self.assertTrue(np.allclose(mat.C, C))
+
+    def test_LinearHardening_refresh_index(self):
+
+        shape = [2, 3]
+        args = dict(
+            K=np.random.random(shape),
+            G=np.random.random(shape),
+            tauy0=1e-3 * np.random.random(shape),
+            H=np.random.random(shape),
+        )
+        mat = GMat.LinearHardening2d(**args)
+        sub = GMat.LinearHardening2d(**args)
+        det = GMat.LinearHardening2d(**args)
+        det.detect_changes = True
+
+        F = tensor.Array2d(shape).I2 + 0.05 * np.random.random(shape + [3, 3])
+        mat.F = F
+        sub.F = F
+        det.F = F
+
+        index = np.array([1, 4], dtype=np.uintp)
+        mask = np.zeros(shape, dtype=bool)
+        mask.flat[index] = True
+
+        for i in range(3):
+            F.reshape(-1, 3, 3)[index] += 0.02 * np.random.random([index.size, 3, 3])
+            mat.F = F
+            det.F = F
+            if i % 2 == 0:
+                sub.set_F_index(index, F.reshape(-1, 3, 3)[index])
+            else:
+                sub.set_F_index(index, F.reshape(-1, 3, 3)[index], compute_tangent=False)
+                sub.refresh_mask(mask)
+
+            for m in [sub, det]:
+                self.assertTrue(np.allclose(m.F, F))
+                self.assertTrue(np.allclose(m.Sig, mat.Sig))
+                self.assertTrue(np.allclose(m.Be, mat.Be))
+                self.assertTrue(np.allclose(m.epsp, mat.epsp))
+                self.assertTrue(np.allclose(m.C, mat.C))
+
+    def test_LinearHardening_phase(self):
+
+        shape = [2, 3]
+        phase = np.random.randint(3, size=shape).astype(np.uintp)
+        K = np.random.random(3)
+        G = np.random.random(3)
+        tauy0 = 1e-3 * np.random.random(3)
+        H = np.random.random(3)
+
+        mat = GMat.LinearHardening2d(K=K[phase], G=G[phase], tauy0=tauy0[phase], H=H[phase])
+        tab = GMat.LinearHardening2d(phase=phase, K=K, G=G, tauy0=tauy0, H=H)
+        uni = GMat.LinearHardening2d(shape=shape, K=K[0], G=G[0], tauy0=tauy0[0], H=H[0])
+        ref = GMat.LinearHardening2d(
+            K=K[0] * np.ones(shape),
+            G=G[0] * np.ones(shape),
+            tauy0=tauy0[0] * np.ones(shape),
+            H=H[0] * np.ones(shape),
+        )
+
+        self.assertEqual(tab.parameter_storage, GMat.ParameterStorage.Phase)
+        self.assertEqual(uni.parameter_storage, GMat.ParameterStorage.Uniform)
+        self.assertTrue(np.all(tab.phase == phase))
+        self.assertTrue(np.allclose(tab.tauy0, mat.tauy0))
+        self.assertTrue(np.allclose(uni.H, ref.H))
+
+        F = tensor.Array2d(shape).I2 + 0.05 * np.random.random(shape + [3, 3])
+
+        for a, b in [(mat, tab), (ref, uni)]:
+            a.F = F
+            b.F = F
+            self.assertTrue(np.allclose(a.Sig, b.Sig))
+            self.assertTrue(np.allclose(a.epsp, b.epsp))
+            self.assertTrue(np.allclose(a.C, b.C))
+
+    def test_Elastic_phase(self):
+
+        shape = [2, 3]
+        phase = np.random.randint(3, size=shape).astype(np.uintp)
+        K = np.random.random(3)
+        G = np.random.random(3)
+
+        mat = GMat.Elastic2d(K=K[phase], G=G[phase])
+        tab = GMat.Elastic2d(phase=phase, K=K, G=G)
+        uni = GMat.Elastic2d(shape=shape, K=K[0], G=G[0])
+        ref = GMat.Elastic2d(K=K[0] * np.ones(shape), G=G[0] * np.ones(shape))
+
+        self.assertEqual(tab.parameter_storage, GMat.ParameterStorage.Phase)
+        self.assertEqual(uni.parameter_storage, GMat.ParameterStorage.Uniform)
+        self.assertTrue(np.allclose(tab.G, mat.G))
+        self.assertTrue(np.allclose(uni.K, ref.K))
+
+        F = tensor.Array2d(shape).I2 + 0.05 * np.random.random(shape + [3, 3])
+
+        for a, b in [(mat, tab), (ref, uni)]:
+            a.F = F
+            b.F = F
+            self.assertTrue(np.allclose(a.Sig, b.Sig))
+            self.assertTrue(np.allclose(a.C, b.C))
+
+    def test_LinearHardening_float(self):
+
+        shape = [2, 3]
+        args = dict(
+            K=np.random.random(shape),
+            G=np.random.random(shape),
+            tauy0=1e-3 * np.random.random(shape),
+            H=np.random.random(shape),
+        )
+        mat = GMat.LinearHardening2d(**args)
+        sgl = GMat.LinearHardening2dFloat(**args)
+        eps = np.finfo(np.float32).eps
+
+        for i in range(3):
+            F = tensor.Array2d(shape).I2 + 0.02 * i * np.random.random(shape + [3, 3])
+            mat.F = F
+            sgl.F = F
+            self.assertEqual(sgl.C.dtype, np.float32)
+            self.assertTrue(np.all(np.equal(mat.Sig, sgl.Sig)))
+            self.assertTrue(np.all(np.equal(mat.epsp, sgl.epsp)))
+            # the only loss of accuracy is the rounding of the stored tangent
+            err = np.max(np.abs(mat.C - sgl.C)) / np.max(np.abs(mat.C))
+            self.assertLess(err, 2 * eps)
+            mat.increment()
+            sgl.increment()
+
+    def test_Elastic_float(self):
+
+        shape = [2, 3]
+        args = dict(K=np.random.random(shape), G=np.random.random(shape))
+        mat = GMat.Elastic2d(**args)
+        sgl = GMat.Elastic2dFloat(**args)
+        eps = np.finfo(np.float32).eps
+
+        for i in range(3):
+            F = tensor.Array2d(shape).I2 + 0.02 * i * np.random.random(shape + [3, 3])
+            mat.F = F
+            sgl.F = F
+            self.assertEqual(sgl.C.dtype, np.float32)
+            self.assertTrue(np.all(np.equal(mat.Sig, sgl.Sig)))
+            err = np.max(np.abs(mat.C - sgl.C)) / np.max(np.abs(mat.C))
+            self.assertLess(err, 2 * eps)
+
+    def test_LinearHardening_element(self):
+
+        nelem, nip, nne = 3, 4, 4
+        shape = [nelem, nip]
+        args = dict(
+            K=np.random.random(shape),
+            G=np.random.random(shape),
+            tauy0=1e-3 * np.random.random(shape),
+            H=np.random.random(shape),
+        )
+        mat = GMat.LinearHardening2d(**args)
+        elem = GMat.LinearHardening2d(**args)
+        dNdx = np.random.random(shape + [nne, 3]) - 0.5
+        dV = np.random.random(shape)
+        fe = np.empty([nelem, nne, 3])
+        Ke = np.empty([nelem, nne * 3, nne * 3])
+
+        for i in range(3):
+            F = tensor.Array2d(shape).I2 + 0.02 * i * np.random.random(shape + [3, 3])
+            mat.F = F
+            elem.F = F
+            elem.refresh_element(dNdx, dV, fe, Ke)
+            f = np.einsum("eqac,eqcd,eq->ead", dNdx, mat.Sig, dV).reshape(fe.shape)
+            K = np.einsum("eqac,eqcdgf,eqbf,eq->eadbg", dNdx, mat.C, dNdx, dV).reshape(Ke.shape)
+            self.assertTrue(np.allclose(fe, f))
+            self.assertTrue(np.allclose(Ke, K))
+            self.assertTrue(np.allclose(elem.epsp, mat.epsp))
+            mat.increment()
+            elem.increment()
+
+        # the last axis is that of the integration points: at least two axes are needed
+        flat = GMat.LinearHardening1d(**{key: value.ravel() for key, value in args.items()})
+        with self.assertRaises(RuntimeError):
+            flat.refresh_element(dNdx.reshape(-1, nne, 3), dV.ravel(), fe, Ke)
+
+    def test_Elastic_element(self):
+
+        nelem, nip, nne = 3, 4, 4
+        shape = [nelem, nip]
+        mat = GMat.Elastic2d(K=np.random.random(shape), G=np.random.random(shape))
+        elem = GMat.Elastic2d(K=mat.K, G=mat.G)
+        dNdx = np.random.random(shape + [nne, 3]) - 0.5
+        dV = np.random.random(shape)
+        fe = np.empty([nelem, nne, 3])
+        Ke = np.empty([nelem, nne * 3, nne * 3])
+
+        for i in range(3):
+            F = tensor.Array2d(shape).I2 + 0.02 * i * np.random.random(shape + [3, 3])
+            mat.F = F
+            elem.F = F
+            elem.refresh_element(dNdx, dV, fe, Ke)
+            f = np.einsum("eqac,eqcd,eq->ead", dNdx, mat.Sig, dV).reshape(fe.shape)
+            K = np.einsum("eqac,eqcdgf,eqbf,eq->eadbg", dNdx, mat.C, dNdx, dV).reshape(Ke.shape)
+            self.assertTrue(np.allclose(fe, f))
+            self.assertTrue(np.allclose(Ke, K))
+            self.assertTrue(np.allclose(elem.Sig, mat.Sig))
+
+    def test_LinearHardening_outputs(self):
+
+        shape = [2, 3]
+        mat = GMat.LinearHardening2d(
+            K=np.random.random(shape),
+            G=np.random.random(shape),
+            tauy0=1e-3 * np.random.random(shape),
+            H=np.random.random(shape),
+        )
+        mat.outputs = (
+            GMat.Output.Sigeq
+            | GMat.Output.Epseq
+            | GMat.Output.J
+            | GMat.Output.Energy
+            | GMat.Output.Dissipation
+        )
+
+        for i in range(3):
+            F = tensor.Array2d(shape).I2 + 0.02 * i * np.random.random(shape + [3, 3])
+            epsp_t = np.copy(mat.epsp)
+            mat.F = F
+            self.assertTrue(np.allclose(mat.sigeq, GMat.Sigeq(mat.Sig)))
+            self.assertTrue(np.allclose(mat.epseq, GMat.Epseq(GMat.Strain(F))))
+            self.assertTrue(np.allclose(mat.J, np.linalg.det(F)))
+            # elastic logarithmic strain "0.5 * ln(Be)"
+            val, vec = np.linalg.eigh(mat.Be)
+            Epse = np.einsum("...ip,...p,...jp->...ij", vec, 0.5 * np.log(val), vec)
+            self.assertTrue(np.allclose(mat.energy, energy(mat.K, mat.G, Epse)))
+            self.assertTrue(np.allclose(mat.dissipation, mat.tauy0 * (mat.epsp - epsp_t)))
+            mat.increment()
+
+    def test_Elastic_outputs(self):
+
+        shape = [2, 3]
+        mat = GMat.Elastic2d(K=np.random.random(shape), G=np.random.random(shape))
+        mat.outputs = GMat.Output.Sigeq | GMat.Output.Epseq | GMat.Output.J | GMat.Output.Energy
+
+        for i in range(3):
+            F = tensor.Array2d(shape).I2 + 0.02 * i * np.random.random(shape + [3, 3])
+            mat.F = F
+            self.assertTrue(np.allclose(mat.sigeq, GMat.Sigeq(mat.Sig)))
+            self.assertTrue(np.allclose(mat.epseq, GMat.Epseq(GMat.Strain(F))))
+            self.assertTrue(np.allclose(mat.J, np.linalg.det(F)))
+            self.assertTrue(np.allclose(mat.energy, energy(mat.K, mat.G, GMat.Strain(F))))
+
+        # "None" is a keyword in Python: the value is accessed by name
+        mat.outputs = getattr(GMat.Output, "None")
+        self.assertEqual(mat.outputs, int(getattr(GMat.Output, "None")))
+        mat.F = tensor.Array2d(shape).I2
+
+    def test_pointer(self):
+
+        shape = [2, 3]
+        mat = GMat.LinearHardening2d(
+            K=np.random.random(shape),
+            G=np.random.random(shape),
+            tauy0=1e-3 * np.random.random(shape),
+            H=np.random.random(shape),
+        )
+        elas = GMat.Elastic2d(K=mat.K, G=mat.G)
+        Sig = np.empty([3, 3])
+        Be = np.empty([3, 3])
+        C = np.empty([3, 3, 3, 3])
+        Cpinv_t = np.empty([3, 3])
+
+        F_t = tensor.Array2d(shape).I2 + 0.02 * np.random.random(shape + [3, 3])
+        mat.F = F_t
+        mat.increment()
+        Be_t = np.copy(mat.Be)
+        epsp_t = np.copy(mat.epsp)
+
+        F = F_t + 0.02 * np.random.random(shape + [3, 3])
+        mat.F = F
+        elas.F = F
+
+        for i in np.ndindex(*shape):
+            GMat.pointer.linear_hardening_history(F_t[i], Be_t[i], Cpinv_t)
+            epsp = GMat.pointer.linear_hardening_stress_tangent(
+                mat.K[i], mat.G[i], mat.tauy0[i], mat.H[i], F[i], Cpinv_t, epsp_t[i], Sig, Be, C
+            )
+            self.assertTrue(np.allclose(Sig, mat.Sig[i]))
+            self.assertTrue(np.allclose(Be, mat.Be[i]))
+            self.assertTrue(np.isclose(epsp, mat.epsp[i]))
+            self.assertTrue(np.allclose(C, mat.C[i]))
+
+            GMat.pointer.elastic_stress_tangent(
+                elas.K[i], elas.G[i], F[i], Sig, C, solver=GMat.Eigensolver.Jacobi
+            )
+            self.assertTrue(np.allclose(Sig, elas.Sig[i]))
+            self.assertTrue(np.allclose(C, elas.C[i]))
+
+        self.assertTrue(np.any(mat.epsp > epsp_t))
+
+    def test_LinearHardening_instrumentation(self):
+
+        shape = [2, 3]
+        mat = GMat.LinearHardening2d(
+            K=np.ones(shape), G=np.ones(shape), tauy0=1e-3 * np.ones(shape), H=np.ones(shape)
+        )
+        F = tensor.Array2d(shape).I2
+        F[0, :, 0, 1] = 0.1
+        mat.F = F
+        r = mat.instrumentation
+
+        if not r.enabled:
+            self.assertEqual(r.items, 0)
+            return
+
+        self.assertEqual(r.items, np.prod(shape))
+        self.assertEqual(r.yielded, np.sum(mat.epsp > 0))
+        self.assertEqual(sum(r.thread_items), r.items)
+        self.assertEqual(sum(r.thread_yielded), r.yielded)
+
 
 if __name__ == "__main__":
 